@@ -3,11 +3,73 @@
 // Include libraries:
 
 #include "RGBLED.h"
+#include "RGBLED_Pattern.h"
+
+#if RGBLED_ENABLE_COLOR_TABLE
+// ##################################################################################
+// Gamma curve:
+
+/// Gamma 2.2 curve (non-zero inputs map to at least 1 so dim colours stay visible).
+static const uint8_t RGBLED_GAMMA8[256] PROGMEM = {
+    0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+    6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+   12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+   20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+   30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+   42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+   56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+   73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+   91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+  113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+  137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+  163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+  192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+  223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+#endif
+
+#if RGBLED_ENABLE_FADE
+/// Bits of RGBLED::_fadeFlags (RGBLED::isFading tests the first two).
+static const uint8_t RGBLED_FADE_COLOR      = 0x01;
+static const uint8_t RGBLED_FADE_BRIGHTNESS = 0x02;
+static const uint8_t RGBLED_FADE_BRI_LATER  = 0x04;  ///< The brightness fade starts at _fadeT0 + _fadeOff.
+#endif
+
+#if RGBLED_ENABLE_DITHER
+/// x * s / 255 rounded to nearest (within 0.502) for an 8.8 value @p x, without a divide.
+static inline uint16_t RGBLED_div255(uint16_t x, uint8_t s)
+{
+  const uint32_t p = (uint32_t)x * s + 127u;
+  return (uint16_t)((p + (p >> 8) + (p >> 16) + 1u) >> 8);
+}
+#endif
+
+#if RGBLED_ENABLE_DITHER && RGBLED_ENABLE_EFFECTS
+/// a * b / 255 as 8.8 fixed point (255 * 255 -> 255.0, 0 stays 0).
+static inline uint16_t RGBLED_mul88(uint8_t a, uint8_t b)
+{
+  const uint16_t p = (uint16_t)a * b;
+  return (uint16_t)(p + ((p + 255u) >> 8));
+}
+#endif
 
 // ##################################################################################
 // RGBLED Class:
 
+// Per-instance RAM budget on AVR with default options (44 bytes incl. RGBLED_BlinkTimer, driver,
+// elided-write counter and the 9 bytes of cached port registers; 35 with RGBLED_FAST_GPIO 0).
+// Optional features add their own state; raise it only together with new always-on state.
+#if defined(__AVR__) && !RGBLED_ENABLE_STATS && !RGBLED_ENABLE_DITHER && !RGBLED_ENABLE_TRACE && \
+    !RGBLED_ENABLE_FADE && !RGBLED_ENABLE_PATTERNS && !RGBLED_ENABLE_EFFECTS && \
+    !RGBLED_ENABLE_COLOR_TABLE && !RGBLED_ENABLE_SOFTPWM
+static_assert(sizeof(RGBLED) <= (RGBLED_FAST_GPIO ? 44 : 35), "RGBLED per-instance state grew; check the member layout");
+#endif
+
 RGBLED::RGBLED()
+  : _onLevel(true), _isOn(false), _initFlag(false), _pwmEnabled(false),
+    _gamma(false), _lastValid(false), _fastGpio(false), _samePort(false)
 {
   parameters.RED_PIN = -1;
   parameters.GREEN_PIN = -1;
@@ -47,10 +109,14 @@ bool RGBLED::init(void)
   pinMode(parameters.GREEN_PIN, OUTPUT);
   pinMode(parameters.BLUE_PIN, OUTPUT);
 
-  _redDesired = _greenDesired = _blueDesired = false;
+  _resolvePorts();
+  _driver.begin((uint8_t)parameters.RED_PIN, (uint8_t)parameters.GREEN_PIN, (uint8_t)parameters.BLUE_PIN);
+
   _isOn = false;
-  _blinkActive = false;
+  _blink.stop();
   _r8 = _g8 = _b8 = 0;
+  _clearColorLo();
+  _lastValid = false;    // pins were just preloaded with digitalWrite; force the first write
 
   _initFlag = true;      // allow blink() etc.
   off();                 // now effective (or delete this line entirely)
@@ -62,14 +128,15 @@ void RGBLED::set(bool redState, bool greenState, bool blueState)
 {
   if (!_initFlag) return;  // Guard (1)
 
-  _redDesired   = redState;
-  _greenDesired = greenState;
-  _blueDesired  = blueState;
+#if RGBLED_ENABLE_FADE
+  _fadeFlags &= (uint8_t)~RGBLED_FADE_COLOR;
+#endif
 
   // Map boolean -> 8-bit desired cache for unified path
-  _r8 = _redDesired   ? 255 : 0;
-  _g8 = _greenDesired ? 255 : 0;
-  _b8 = _blueDesired  ? 255 : 0;
+  _r8 = redState   ? 255 : 0;
+  _g8 = greenState ? 255 : 0;
+  _b8 = blueState  ? 255 : 0;
+  _clearColorLo();
   _applyOutputs();
 
   _isOn = true;  // reflect that the cached color is now being shown
@@ -81,21 +148,21 @@ void RGBLED::off(void)
   if (!_initFlag) return;  // Guard (1)
 
   _isOn = false;
+#if RGBLED_ENABLE_EFFECTS
+  _effKind = RGBLED_EFFECT_NONE;
+#endif
   // OFF means "not lit" regardless of wiring:
   // For CC: write LOW; For CA: write HIGH.
   const uint8_t offLevel = (_onLevel ? LOW : HIGH);
   
   if (_pwmEnabled) 
   {
-    analogWrite(parameters.RED_PIN,   (_onLevel ? 0   : 255)); // 0 duty = off for CC; 255 for CA
-    analogWrite(parameters.GREEN_PIN, (_onLevel ? 0   : 255));
-    analogWrite(parameters.BLUE_PIN,  (_onLevel ? 0   : 255));
+    const uint8_t offDuty = (_onLevel ? 0 : 255); // 0 duty = off for CC; 255 for CA
+    _writeOutputs(offDuty, offDuty, offDuty);
   } 
   else 
   {
-    digitalWrite(parameters.RED_PIN,   offLevel);
-    digitalWrite(parameters.GREEN_PIN, offLevel);
-    digitalWrite(parameters.BLUE_PIN,  offLevel);
+    _writeOutputs(offLevel, offLevel, offLevel);
   }
 }
 
@@ -104,7 +171,7 @@ void RGBLED::on()
   if (!_initFlag) return;  // Guard (1)
 
   _applyOutputs();
-  _isOn = ((_r8 | _g8 | _b8) != 0);
+  _isOn = _hasColor();
 }
 
 void RGBLED::toggle() 
@@ -120,72 +187,395 @@ void RGBLED::inverse(void)
   if (!_initFlag) return;  // Guard (1)
 
   // Invert each desired channel and then show it.
-  set(!_redDesired, !_greenDesired, !_blueDesired);
+  set(_r8 == 0, _g8 == 0, _b8 == 0);
 }
 
 void RGBLED::setRGB(uint8_t r, uint8_t g, uint8_t b)
 {
   if (!_initFlag) return;  // Guard (1)
+#if RGBLED_ENABLE_FADE
+  _fadeFlags &= (uint8_t)~RGBLED_FADE_COLOR;
+#endif
   _r8 = r; _g8 = g; _b8 = b;
-  // Keep logical booleans in sync for callers that read them
-  _redDesired   = (r != 0);
-  _greenDesired = (g != 0);
-  _blueDesired  = (b != 0);
+  _clearColorLo();
   _applyOutputs();
   _isOn = (_r8 | _g8 | _b8) != 0;
 }
 
+#if RGBLED_ENABLE_DITHER
+void RGBLED::setRGB16(uint16_t r, uint16_t g, uint16_t b)
+{
+  if (!_initFlag) return;  // Guard (1)
+#if RGBLED_ENABLE_FADE
+  _fadeFlags &= (uint8_t)~RGBLED_FADE_COLOR;
+#endif
+
+  // 0..65535 -> 8.8 (x * 65280/65535 = x - x/257, rounded), so 65535 is exactly 255.0
+  r -= (uint16_t)(((uint32_t)r * 255u + 0x8000u) >> 16);
+  g -= (uint16_t)(((uint32_t)g * 255u + 0x8000u) >> 16);
+  b -= (uint16_t)(((uint32_t)b * 255u + 0x8000u) >> 16);
+  _r8 = (uint8_t)(r >> 8); _g8 = (uint8_t)(g >> 8); _b8 = (uint8_t)(b >> 8);
+  _colorLo[0] = (uint8_t)r; _colorLo[1] = (uint8_t)g; _colorLo[2] = (uint8_t)b;
+  _applyOutputs();
+  _isOn = _hasColor();
+}
+
+void RGBLED::enableDither(uint8_t frame_ms)
+{
+  _ditherFrameMs = frame_ms;
+  _ditherNext = millis();
+  if (_initFlag && _isOn) _applyOutputs();
+}
+
+void RGBLED::_showColor16(uint16_t r, uint16_t g, uint16_t b)
+{
+  // x * brightness / 255, rounded: one multiply per channel per color change.
+  _ditherTarget[0] = RGBLED_div255(r, _brightness);
+  _ditherTarget[1] = RGBLED_div255(g, _brightness);
+  _ditherTarget[2] = RGBLED_div255(b, _brightness);
+  _ditherFrame(false);
+}
+
+void RGBLED::_ditherFrame(bool advance)
+{
+  // First-order error diffusion: the fraction accumulates, its carry adds one duty step.
+  // Only the frame clock advances the accumulators, so every 256 frames average exactly.
+  uint8_t out[3];
+  for (uint8_t c = 0; c < 3; ++c)
+  {
+    const uint16_t sum = (uint16_t)_ditherAcc[c] + (uint8_t)_ditherTarget[c];
+    if (advance) _ditherAcc[c] = (uint8_t)sum;
+    out[c] = (uint8_t)((_ditherTarget[c] >> 8) + (sum >> 8));  // target <= 255.0: no overflow
+  }
+
+  if (_onLevel) _writeOutputs(out[0], out[1], out[2]);
+  else          _writeOutputs(255 - out[0], 255 - out[1], 255 - out[2]);
+}
+#endif
+
+void RGBLED::setHSV(uint8_t h, uint8_t s, uint8_t v)
+{
+  uint8_t r, g, b;
+  RGBLED_hsvToRgb(h, s, v, r, g, b);
+  setRGB(r, g, b);
+}
+
+void RGBLED::setKelvin(uint16_t kelvin, uint8_t v)
+{
+  uint8_t r, g, b;
+  RGBLED_kelvinToRgb(kelvin, r, g, b);
+  setRGB(RGBLED_scale8(r, v), RGBLED_scale8(g, v), RGBLED_scale8(b, v));
+}
+
 void RGBLED::_applyOutputs()
 {
-  // Brightness scaling (0..255)
-  uint16_t r = (uint16_t)_r8 * _brightness / 255;
-  uint16_t g = (uint16_t)_g8 * _brightness / 255;
-  uint16_t b = (uint16_t)_b8 * _brightness / 255;
+#if RGBLED_ENABLE_STATS
+  _stats.applyCalls++;
+#endif
+
+#if RGBLED_ENABLE_EFFECTS
+  if (_effKind) { _effectUpdate(millis()); return; }
+#endif
+#if RGBLED_ENABLE_DITHER
+  if (_ditherOn())
+  {
+    _showColor16((uint16_t)(_r8 << 8) | _colorLo[0], (uint16_t)(_g8 << 8) | _colorLo[1],
+                 (uint16_t)(_b8 << 8) | _colorLo[2]);
+    return;
+  }
+#endif
+  _showColor(_r8, _g8, _b8);
+}
+
+void RGBLED::_showColor(uint8_t r, uint8_t g, uint8_t b)
+{
+#if RGBLED_ENABLE_DITHER
+  if (_ditherOn()) { _showColor16((uint16_t)(r << 8), (uint16_t)(g << 8), (uint16_t)(b << 8)); return; }
+#endif
+
+  // Brightness scaling (0..255): fused table lookup, or plain x*b/255
+#if RGBLED_ENABLE_COLOR_TABLE
+  if (_colorTable)
+  {
+    r = _colorTable->lut[0][r];
+    g = _colorTable->lut[1][g];
+    b = _colorTable->lut[2][b];
+  }
+  else
+#endif
+  {
+    r = RGBLED_scale8(r, _brightness);
+    g = RGBLED_scale8(g, _brightness);
+    b = RGBLED_scale8(b, _brightness);
+  }
 
   if (_pwmEnabled) {
     // Apply wiring mode (CA inverts)
     uint8_t pr = _onLevel ? r : (255 - r);
     uint8_t pg = _onLevel ? g : (255 - g);
     uint8_t pb = _onLevel ? b : (255 - b);
-    analogWrite(parameters.RED_PIN,   pr);
-    analogWrite(parameters.GREEN_PIN, pg);
-    analogWrite(parameters.BLUE_PIN,  pb);
+    _writeOutputs(pr, pg, pb);
   } else {
     // Digital writes: non-zero -> ON
     const bool rOn = (_onLevel ? (r != 0) : (r == 0));
     const bool gOn = (_onLevel ? (g != 0) : (g == 0));
     const bool bOn = (_onLevel ? (b != 0) : (b == 0));
-    digitalWrite(parameters.RED_PIN,   rOn ? HIGH : LOW);
-    digitalWrite(parameters.GREEN_PIN, gOn ? HIGH : LOW);
-    digitalWrite(parameters.BLUE_PIN,  bOn ? HIGH : LOW);
+    _writeOutputs(rOn ? HIGH : LOW, gOn ? HIGH : LOW, bOn ? HIGH : LOW);
   }
 }
 
+void RGBLED::_writeOutputs(uint8_t r, uint8_t g, uint8_t b)
+{
+  // Bit i set -> channel i differs from what the pin already holds.
+  uint8_t dirty = 0x07;
+  if (_lastValid)
+  {
+    dirty = (uint8_t)((r != _lastR ? 0x01 : 0) | (g != _lastG ? 0x02 : 0) | (b != _lastB ? 0x04 : 0));
+  }
+
+  const uint8_t writes = (uint8_t)((dirty & 1) + ((dirty >> 1) & 1) + ((dirty >> 2) & 1));
+  _elidedWrites += (uint8_t)(3 - writes);
+#if RGBLED_ENABLE_STATS
+  _stats.pinWrites += writes;
+#endif
+#if RGBLED_ENABLE_TRACE
+  // Every requested write is recorded; clean channels are flagged as elided.
+  if (_trace)
+  {
+    const uint32_t now = millis();
+    _trace->record(now, (uint8_t)parameters.RED_PIN,   r, !(dirty & 0x01));
+    _trace->record(now, (uint8_t)parameters.GREEN_PIN, g, !(dirty & 0x02));
+    _trace->record(now, (uint8_t)parameters.BLUE_PIN,  b, !(dirty & 0x04));
+  }
+#endif
+  if (!dirty) return;
+
+  _lastR = r; _lastG = g; _lastB = b;
+  _lastValid = true;
+
+#if RGBLED_ENABLE_SOFTPWM
+  if (_pwmEnabled && _softPwm)
+  {
+    if (dirty & 0x01) _softPwm->setDuty(_softCh,     r);
+    if (dirty & 0x02) _softPwm->setDuty(_softCh + 1, g);
+    if (dirty & 0x04) _softPwm->setDuty(_softCh + 2, b);
+  }
+  else
+#endif
+  if (_pwmEnabled)
+  {
+    _driver.write3(r, g, b, dirty);
+  }
+  else
+  {
+    _writeDigital(r, g, b, dirty);
+  }
+}
+
+void RGBLED::setBrightness(uint8_t b)
+{
+#if RGBLED_ENABLE_FADE
+  _fadeFlags &= (uint8_t)~RGBLED_FADE_BRIGHTNESS;
+#endif
+  _applyBrightness(b);
+}
+
+void RGBLED::_applyBrightness(uint8_t b)
+{
+  if (b == _brightness) return;
+  _brightness = b;
+#if RGBLED_ENABLE_COLOR_TABLE
+  _rebuildColorTable();
+#endif
+  if (_initFlag && _isOn) _applyOutputs();
+}
+
+#if RGBLED_ENABLE_COLOR_TABLE
+void RGBLED::attachColorTable(RGBLED_ColorTable* table)
+{
+  _colorTable = table;
+  _rebuildColorTable();
+  if (_initFlag && _isOn) _applyOutputs();
+}
+
+void RGBLED::setWhiteBalance(uint8_t rGain, uint8_t gGain, uint8_t bGain)
+{
+  _gainR = rGain; _gainG = gGain; _gainB = bGain;
+  _rebuildColorTable();
+  if (_initFlag && _isOn) _applyOutputs();
+}
+
+void RGBLED::enableGamma(bool en)
+{
+  _gamma = en;
+  _rebuildColorTable();
+  if (_initFlag && _isOn) _applyOutputs();
+}
+
+void RGBLED::_rebuildColorTable(void)
+{
+  if (!_colorTable) return;
+
+  // Fold white balance and brightness into one factor per channel.
+  const uint8_t kR = RGBLED_scale8(_gainR, _brightness);
+  const uint8_t kG = RGBLED_scale8(_gainG, _brightness);
+  const uint8_t kB = RGBLED_scale8(_gainB, _brightness);
+
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    const uint8_t v = _gamma ? pgm_read_byte(&RGBLED_GAMMA8[i]) : (uint8_t)i;
+    _colorTable->lut[0][i] = RGBLED_scale8(v, kR);
+    _colorTable->lut[1][i] = RGBLED_scale8(v, kG);
+    _colorTable->lut[2][i] = RGBLED_scale8(v, kB);
+  }
+}
+#endif
+
+void RGBLED::enablePWM(bool en)
+{
+  const bool leavingPwm = (_pwmEnabled && !en);
+  if (_pwmEnabled != en) _lastValid = false;  // cached values belong to the other mode
+  _pwmEnabled = en;
+
+#if RGBLED_ENABLE_SOFTPWM
+  if (_softPwm)
+  {
+    // The ISR owns the pins only in PWM mode.
+    for (uint8_t c = 0; c < 3; ++c) _softPwm->enableChannel(_softCh + c, en);
+  }
+#endif
+
+  if (!leavingPwm || !_initFlag) return;
+
+#if RGBLED_ENABLE_SOFTPWM
+  if (!_softPwm)
+#endif
+  _driver.release();
+
+  // digitalWrite() detaches the PWM timer from the pin; direct port writes do not.
+  // Refresh once through the slow path, then the fast path is safe again.
+#if RGBLED_FAST_GPIO
+  _fastGpio = false;
+#endif
+  if (_isOn) _applyOutputs();
+  else       off();
+#if RGBLED_FAST_GPIO
+  _resolvePorts();
+#endif
+}
+
+#if RGBLED_ENABLE_SOFTPWM
+bool RGBLED::attachSoftPWM(RGBLED_SoftPWM& engine)
+{
+#if RGBLED_FAST_GPIO
+  if (!_initFlag || !_fastGpio) return false;
+
+  // All three channels or none: a channel cannot be removed once the ISR drives it.
+  volatile uint8_t* const regs[3] = { _outR, _outG, _outB };
+  if (!engine.canAdd(regs, 3)) return false;
+
+  const int8_t ch = engine.addChannel(_outR, _maskR);
+  engine.addChannel(_outG, _maskG);
+  engine.addChannel(_outB, _maskB);
+
+  _softPwm = &engine;
+  _softCh  = (uint8_t)ch;
+  for (uint8_t c = 0; c < 3; ++c) _softPwm->enableChannel(_softCh + c, _pwmEnabled);
+  _lastValid = false;
+  if (_pwmEnabled)
+  {
+    if (_isOn) _applyOutputs();
+    else       off();
+  }
+  return true;
+#else
+  (void)engine;
+  return false;
+#endif
+}
+#endif
+
+void RGBLED::_writeDigital(uint8_t r, uint8_t g, uint8_t b, uint8_t dirty)
+{
+#if RGBLED_FAST_GPIO
+  if (_fastGpio)
+  {
+    const uint8_t oldSREG = SREG;
+    cli();
+    if (_samePort)
+    {
+      // One read-modify-write: all three channels change together.
+      const uint8_t setBits = (r ? _maskR : 0) | (g ? _maskG : 0) | (b ? _maskB : 0);
+      *_outR = (uint8_t)((*_outR & ~(_maskR | _maskG | _maskB)) | setBits);
+    }
+    else
+    {
+      if (dirty & 0x01) { if (r) *_outR |= _maskR; else *_outR &= (uint8_t)~_maskR; }
+      if (dirty & 0x02) { if (g) *_outG |= _maskG; else *_outG &= (uint8_t)~_maskG; }
+      if (dirty & 0x04) { if (b) *_outB |= _maskB; else *_outB &= (uint8_t)~_maskB; }
+    }
+    SREG = oldSREG;
+    return;
+  }
+#endif
+
+  if (dirty & 0x01) digitalWrite(parameters.RED_PIN,   r);
+  if (dirty & 0x02) digitalWrite(parameters.GREEN_PIN, g);
+  if (dirty & 0x04) digitalWrite(parameters.BLUE_PIN,  b);
+}
+
+void RGBLED::_resolvePorts(void)
+{
+#if RGBLED_FAST_GPIO
+  const uint8_t portR = digitalPinToPort(parameters.RED_PIN);
+  const uint8_t portG = digitalPinToPort(parameters.GREEN_PIN);
+  const uint8_t portB = digitalPinToPort(parameters.BLUE_PIN);
+
+  if (portR == NOT_A_PIN || portG == NOT_A_PIN || portB == NOT_A_PIN)
+  {
+    _fastGpio = false;  // keep the digitalWrite fallback
+    return;
+  }
+
+  _outR  = portOutputRegister(portR);
+  _outG  = portOutputRegister(portG);
+  _outB  = portOutputRegister(portB);
+  _maskR = digitalPinToBitMask(parameters.RED_PIN);
+  _maskG = digitalPinToBitMask(parameters.GREEN_PIN);
+  _maskB = digitalPinToBitMask(parameters.BLUE_PIN);
+
+  _samePort = (_outR == _outG) && (_outR == _outB);
+  _fastGpio = true;
+#endif
+}
+
 void RGBLED::getColor(bool &r, bool &g, bool &b) const
 {
-  r = _redDesired;
-  g = _greenDesired;
-  b = _blueDesired;
+  // Boolean channel states are derived from the single 8-bit color cache.
+  r = (_r8 != 0);
+  g = (_g8 != 0);
+  b = (_b8 != 0);
 }
 
 void RGBLED::stopBlink(bool turnOff)
 {
-  _blinkActive = false;
-  _blinkEdgeCnt = 0;
-  _blinkNumber = 0;
-  _blinkRemainder = 0;
+  _blink.stop();
   if (turnOff) off();
   else _applyOutputs();
 }
 
-void RGBLED::blink(uint16_t duration_ms, uint8_t number, bool blocking) 
+void RGBLED::blink(uint16_t duration_ms, uint32_t number, bool blocking) 
 {
     if (!_initFlag) return;
 
+#if RGBLED_ENABLE_EFFECTS
+    _effKind = RGBLED_EFFECT_NONE;
+#endif
+
     // duration_ms must be > 0 in all modes
     if (duration_ms == 0) 
     {
-        _blinkActive = false;
+        _blink.stop();
         off();
         return;
     }
@@ -194,13 +584,7 @@ void RGBLED::blink(uint16_t duration_ms, uint8_t number, bool blocking)
     if (number == 0) 
     {
         // Interpret duration_ms as HALF-PERIOD
-        _blinkNumber    = 0;            // sentinel: infinite
-        _blinkEdgeCnt   = 0;
-        _blinkActive    = true;
-        _blinkDelayMs   = duration_ms;  // fixed half-period
-        _blinkRemainder = 0;            // not used in infinite mode
-        _currentDelay   = _blinkDelayMs;
-        _tRef           = millis();
+        _blink.startInfinite(duration_ms, millis());
 
         // Start from ON (show cached color)
         on();
@@ -208,55 +592,418 @@ void RGBLED::blink(uint16_t duration_ms, uint8_t number, bool blocking)
     }
 
     // -------- Finite mode (existing behavior) --------
-    const uint32_t edges = 2UL * number;              // ON + OFF edges
-    _blinkDelayMs   = (uint32_t)(duration_ms / edges);
-    _blinkRemainder = (uint16_t)(duration_ms % edges); // spread +1ms over first remainder edges
-    if (_blinkDelayMs == 0 && edges) { _blinkDelayMs = 1; } // avoid zero delay
-    _currentDelay = _blinkDelayMs + (_blinkRemainder ? 1 : 0);
+    _blink.prepare(duration_ms, number);
 
     if (blocking) 
     {
-        const bool r = _redDesired, g = _greenDesired, b = _blueDesired;
+        const bool r = (_r8 != 0), g = (_g8 != 0), b = (_b8 != 0);
 
-        uint16_t rem = _blinkRemainder;
-        for (uint8_t i = 0; i < number; ++i) {
+        // Absolute deadlines: time spent in set()/off() or in the hook does not add up.
+        uint32_t deadline = millis();
+        for (uint32_t i = 0; i < number; ++i) {
             set(r, g, b);
-            delay(_blinkDelayMs + (rem ? 1 : 0)); if (rem) --rem;
+            deadline += _blink.nextDelay();
+            RGBLED_waitUntil(deadline, _waitHook);
             off();
-            delay(_blinkDelayMs + (rem ? 1 : 0)); if (rem) --rem;
+            deadline += _blink.nextDelay();
+            RGBLED_waitUntil(deadline, _waitHook);
         }
     } 
     else 
     {
-        _blinkNumber  = number;
-        _blinkEdgeCnt = 0;
-        _blinkActive  = true;
-        _tRef         = millis();
+        _blink.start(millis());
         on();
     }
 }
 
 void RGBLED::blinkUpdate() 
 {
-  if (!_blinkActive || !_initFlag) return; // Guard (1)
+  update();
+}
 
-  const uint32_t now = millis();
-  if ((uint32_t)(now - _tRef) < _currentDelay) return;
+void RGBLED::update(void)
+{
+#if RGBLED_ENABLE_STATS
+  _stats.updateCalls++;
+#endif
+#if RGBLED_ENABLE_DITHER
+  if (_ditherPending() && _initFlag) { update((uint32_t)millis()); return; }
+#endif
+  if (!_timedBusy() || !_initFlag) return; // Guard (1)
 
-  // time for next edge
-  toggle();
-  _tRef = now;
-  _blinkEdgeCnt++;
-  if (_blinkRemainder) { _blinkRemainder--; }
-  _currentDelay = _blinkDelayMs + (_blinkRemainder ? 1 : 0);
+  update((uint32_t)millis());
+}
 
-  // Stop only in FINITE mode (when _blinkNumber > 0)
-  if (_blinkNumber > 0 && _blinkEdgeCnt >= (uint8_t)(2 * _blinkNumber)) {
-      _blinkActive = false;
-      off();
+void RGBLED::update(uint32_t now)
+{
+  if (!_initFlag) return;  // Guard (1)
+
+#if RGBLED_ENABLE_PATTERNS
+  if (_patBase) _patternUpdate(now);
+#endif
+#if RGBLED_ENABLE_FADE
+  if (isFading()) _fadeUpdate(now);
+#endif
+#if RGBLED_ENABLE_EFFECTS
+  if (_effKind && !_ditherOn()) _effectUpdate(now);
+#endif
+
+#if RGBLED_ENABLE_DITHER
+  // Fixed frame rate; a late loop skips frames instead of bursting them.
+  if (_ditherOn() && (int32_t)(now - _ditherNext) >= 0)
+  {
+    _ditherNext = now + _ditherFrameMs;
+#if RGBLED_ENABLE_EFFECTS
+    if (_effKind)   { _effectUpdate(now); _ditherFrame(true); }
+    else
+#endif
+    if (_isOn) _ditherFrame(true);
+  }
+#endif
+
+#if RGBLED_ENABLE_STATS
+  const uint32_t due = _blink.deadline();
+  uint32_t fired = 0;
+  const RGBLED_BlinkTimer::Event ev = _blink.poll(now, &fired);
+
+  if (fired)
+  {
+    const uint32_t late = now - due;
+    _stats.edgesFired += fired;
+    if (late < _stats.latenessMin) _stats.latenessMin = late;
+    if (late > _stats.latenessMax) _stats.latenessMax = late;
+    _stats.latenessSum += late;
+    _stats.latenessCount++;
+
+    uint8_t bucket = 0;
+    for (uint32_t v = late; v && bucket < 7; v >>= 1) ++bucket;
+    if (_stats.latenessHist[bucket] != 0xFFFF) _stats.latenessHist[bucket]++;
+  }
+#else
+  const RGBLED_BlinkTimer::Event ev = _blink.poll(now);
+#endif
+
+  switch (ev)
+  {
+    case RGBLED_BlinkTimer::EVENT_EDGE: toggle(); break;
+    case RGBLED_BlinkTimer::EVENT_DONE: off();    break;
+    default: break;
   }
 }
 
+bool RGBLED::nextDeadlineMs(uint32_t &deadline) const
+{
+  bool     any = false;
+  uint32_t t   = 0;
+
+  // Earliest of the pending deadlines (wrap-safe comparison).
+  if (_blink.active())                                           { t = _blink.deadline(); any = true; }
+#if RGBLED_ENABLE_PATTERNS
+  if (_patBase && (!any || (int32_t)(_seqT - t) < 0))            { t = _seqT;             any = true; }
+#endif
+#if RGBLED_ENABLE_FADE
+  // A running fade is due from its start on; the earlier start is the shared _fadeT0.
+  if (isFading() && (!any || (int32_t)(_fadeT0 - t) < 0))        { t = _fadeT0;           any = true; }
+#endif
+#if RGBLED_ENABLE_DITHER
+  if (_ditherPending())
+  {
+    // Effects are evaluated on dither frames; otherwise the frame is due with the others.
+    if (_effectOn() || !any || (int32_t)(_ditherNext - t) < 0) t = _ditherNext;
+    any = true;
+  }
+  else
+#endif
+  if (_effectOn()) { t = millis(); any = true; }  // the origin may be moved; "now" is always due
+
+  if (any) deadline = t;
+  return any;
+}
+
+#if RGBLED_ENABLE_FADE
+void RGBLED::fadeTo(uint8_t r, uint8_t g, uint8_t b, uint16_t duration_ms)
+{
+  if (!_initFlag) return;  // Guard (1)
+
+  if (duration_ms == 0) { setRGB(r, g, b); return; }
+
+  // An OFF LED (not in a blink OFF phase) fades in from black.
+  if (!_isOn && !_blink.active())
+  {
+    _r8 = _g8 = _b8 = 0;
+    _clearColorLo();
+    _isOn = true;
+  }
+
+  _fadeFrom[0] = _r8;  _fadeFrom[1] = _g8;  _fadeFrom[2] = _b8;
+  _fadeTarget[0] = r;  _fadeTarget[1] = g;  _fadeTarget[2] = b;
+  // One division at start; ticks only multiply and shift.
+  _fadeRecip    = RGBLED_phaseRate(duration_ms);
+  _fadeDuration = duration_ms;
+  _setFadeStart(RGBLED_FADE_COLOR, millis());
+  _fadeFlags   |= RGBLED_FADE_COLOR;
+}
+
+void RGBLED::fadeBrightness(uint8_t target, uint16_t duration_ms)
+{
+  if (duration_ms == 0) { setBrightness(target); return; }
+
+  _briFrom     = _brightness;
+  _briTarget   = target;
+  _briRecip    = RGBLED_phaseRate(duration_ms);
+  _briDuration = duration_ms;
+  _setFadeStart(RGBLED_FADE_BRIGHTNESS, millis());
+  _fadeFlags  |= RGBLED_FADE_BRIGHTNESS;
+}
+
+uint32_t RGBLED::_fadeStart(uint8_t flag) const
+{
+  const bool later = ((_fadeFlags & RGBLED_FADE_BRI_LATER) != 0) == (flag == RGBLED_FADE_BRIGHTNESS);
+  return later ? _fadeT0 + _fadeOff : _fadeT0;
+}
+
+void RGBLED::_setFadeStart(uint8_t flag, uint32_t t)
+{
+  const uint8_t other = (uint8_t)((RGBLED_FADE_COLOR | RGBLED_FADE_BRIGHTNESS) & ~flag);
+  if (!(_fadeFlags & other))
+  {
+    _fadeT0  = t;
+    _fadeOff = 0;
+    return;
+  }
+
+  uint32_t o = _fadeStart(other);
+  int32_t  d = (int32_t)(t - o);
+  // Clamp the fade that has ended anyway (start moved later, elapsed still >= 65535 ms).
+  if (d > 0xFFFF)  { o = t - 0xFFFF; d = 0xFFFF; }
+  if (d < -0xFFFF) { t = o - 0xFFFF; d = -0xFFFF; }
+
+  const bool flagLater = (d >= 0);
+  _fadeT0  = flagLater ? o : t;
+  _fadeOff = (uint16_t)(flagLater ? d : -d);
+  if (flagLater == (flag == RGBLED_FADE_BRIGHTNESS)) _fadeFlags |= RGBLED_FADE_BRI_LATER;
+  else                                                 _fadeFlags &= (uint8_t)~RGBLED_FADE_BRI_LATER;
+}
+
+void RGBLED::_fadeUpdate(uint32_t now)
+{
+  // Progress f = elapsed * ceil(2^32 / duration) >> 16, 0..65535 while elapsed < duration:
+  // the product stays below 2^32 and the last tick is within 65536/duration of the end.
+  if (_fadeFlags & RGBLED_FADE_BRIGHTNESS)
+  {
+    const uint32_t e = now - _fadeStart(RGBLED_FADE_BRIGHTNESS);
+    uint8_t v = _briTarget;
+    if (e >= _briDuration) _fadeFlags &= (uint8_t)~RGBLED_FADE_BRIGHTNESS;
+    else
+    {
+      const int32_t f = (int32_t)((e * _briRecip) >> 16);
+      v = (uint8_t)(_briFrom + ((((int32_t)_briTarget - _briFrom) * f) >> 16));
+    }
+    _applyBrightness(v);  // no-op if unchanged
+  }
+
+  if (_fadeFlags & RGBLED_FADE_COLOR)
+  {
+    const uint32_t e = now - _fadeStart(RGBLED_FADE_COLOR);
+    uint8_t v[3];
+#if RGBLED_ENABLE_DITHER
+    uint8_t lo[3] = {0, 0, 0};  // fraction of v (8.8)
+#endif
+    if (e >= _fadeDuration)
+    {
+      v[0] = _fadeTarget[0]; v[1] = _fadeTarget[1]; v[2] = _fadeTarget[2];
+      _fadeFlags &= (uint8_t)~RGBLED_FADE_COLOR;
+    }
+    else
+    {
+      const int32_t f = (int32_t)((e * _fadeRecip) >> 16);  // progress 0..65535
+      for (uint8_t c = 0; c < 3; ++c)
+      {
+        const int32_t d = ((int32_t)_fadeTarget[c] - _fadeFrom[c]) * f;
+#if RGBLED_ENABLE_DITHER
+        const uint16_t v16 = (uint16_t)(((int32_t)_fadeFrom[c] << 8) + (d >> 8));  // 8.8
+        v[c] = (uint8_t)(v16 >> 8); lo[c] = (uint8_t)v16;
+#else
+        v[c] = (uint8_t)(_fadeFrom[c] + (d >> 16));
+#endif
+      }
+    }
+
+    bool changed = (v[0] != _r8 || v[1] != _g8 || v[2] != _b8);
+#if RGBLED_ENABLE_DITHER
+    changed |= (lo[0] != _colorLo[0] || lo[1] != _colorLo[1] || lo[2] != _colorLo[2]);
+    _colorLo[0] = lo[0]; _colorLo[1] = lo[1]; _colorLo[2] = lo[2];
+#endif
+    if (changed)
+    {
+      _r8 = v[0]; _g8 = v[1]; _b8 = v[2];
+      if (_isOn) _applyOutputs();  // keep OFF / blink OFF phases dark
+    }
+
+    if (!(_fadeFlags & RGBLED_FADE_COLOR) && _isOn && !_blink.active())
+    {
+      _isOn = _hasColor();
+    }
+  }
+}
+#endif
+
+#if RGBLED_ENABLE_PATTERNS
+void RGBLED::playPattern(const uint8_t* pattern)
+{
+  if (!_initFlag || !pattern) return;  // Guard (1)
+
+  _blink.stop();
+#if RGBLED_ENABLE_EFFECTS
+  _effKind = RGBLED_EFFECT_NONE;
+#endif
+  _patBase = pattern;
+  _patPC   = 0;
+  _patLoop = 0;
+  _seqT    = millis();
+  _patternUpdate(_seqT);  // run up to the first wait now
+}
+
+void RGBLED::stopPattern(bool turnOff)
+{
+  _patBase = nullptr;
+#if RGBLED_ENABLE_FADE
+  _fadeFlags &= (uint8_t)~RGBLED_FADE_COLOR;
+#endif
+  if (turnOff) off();
+}
+
+void RGBLED::_patternUpdate(uint32_t now)
+{
+  if ((int32_t)(now - _seqT) < 0) return;
+
+  // Bound the work per call, so a pattern that jumps without waiting cannot stall loop().
+  for (uint8_t budget = 16; budget && _patBase; --budget)
+  {
+    const uint8_t* p = _patBase + _patPC;
+    const uint8_t op = pgm_read_byte(p);
+
+    switch (op)
+    {
+      case RGBLED_OP_COLOR:
+        setRGB(pgm_read_byte(p + 1), pgm_read_byte(p + 2), pgm_read_byte(p + 3));
+        _patPC += 4;
+        break;
+
+      case RGBLED_OP_OFF:
+        off();
+        _patPC += 1;
+        break;
+
+      case RGBLED_OP_HOLD:
+      {
+        const uint16_t ms = (uint16_t)(pgm_read_byte(p + 1) | (pgm_read_byte(p + 2) << 8));
+        _patPC += 3;
+        _seqT += ms;  // absolute: no drift from loop lateness
+        if ((int32_t)(now - _seqT) < 0) return;
+        break;
+      }
+
+      case RGBLED_OP_FADE:
+      {
+        const uint16_t ms = (uint16_t)(pgm_read_byte(p + 4) | (pgm_read_byte(p + 5) << 8));
+#if RGBLED_ENABLE_FADE
+        fadeTo(pgm_read_byte(p + 1), pgm_read_byte(p + 2), pgm_read_byte(p + 3), ms);
+        if (ms) _setFadeStart(RGBLED_FADE_COLOR, _seqT);  // fade on the pattern timeline, not the poll time
+#else
+        setRGB(pgm_read_byte(p + 1), pgm_read_byte(p + 2), pgm_read_byte(p + 3));  // no fades compiled in: cut
+#endif
+        _patPC += 6;
+        _seqT += ms;
+        if ((int32_t)(now - _seqT) < 0) return;
+        break;
+      }
+
+      case RGBLED_OP_REPEAT:
+        if (_patLoop == 0) _patLoop = pgm_read_byte(p + 1);
+        if (--_patLoop) _patPC = pgm_read_byte(p + 2);
+        else            _patPC += 3;
+        break;
+
+      case RGBLED_OP_JUMP:
+        _patPC = pgm_read_byte(p + 1);
+        _patLoop = 0;  // leaving a repeat body ends that loop; the next REPEAT loads its count
+        break;
+
+      case RGBLED_OP_END:
+      default:
+        _patBase = nullptr;
+        return;
+    }
+  }
+}
+#endif
+
+#if RGBLED_ENABLE_EFFECTS
+void RGBLED::breathe(uint16_t period_ms)                 { _startEffect(RGBLED_EFFECT_BREATHE,   period_ms, 0); }
+void RGBLED::heartbeat(uint16_t period_ms)               { _startEffect(RGBLED_EFFECT_HEARTBEAT, period_ms, 0); }
+void RGBLED::strobe(uint16_t period_ms, uint8_t duty)    { _startEffect(RGBLED_EFFECT_STROBE,    period_ms, duty); }
+void RGBLED::rainbow(uint16_t period_ms)                 { _startEffect(RGBLED_EFFECT_RAINBOW,   period_ms, 0); }
+
+void RGBLED::stopEffect(bool turnOff)
+{
+  _effKind = RGBLED_EFFECT_NONE;
+  if (turnOff) off();
+  else if (_isOn) _applyOutputs();
+}
+
+void RGBLED::_startEffect(uint8_t kind, uint16_t period_ms, uint8_t param)
+{
+  if (!_initFlag) return;  // Guard (1)
+
+  if (period_ms == 0) { stopEffect(true); return; }
+
+  // Effects own the output; a color fade keeps running and changes the modulated color.
+  _blink.stop();
+#if RGBLED_ENABLE_PATTERNS
+  _patBase = nullptr;
+#endif
+
+  if (!_hasColor()) { _r8 = _g8 = _b8 = 255; _clearColorLo(); }
+
+  _effKind  = kind;
+  _effParam = param;
+  _effRate  = RGBLED_phaseRate(period_ms);  // one division per start
+  _seqT     = millis();
+  _isOn     = true;
+  _effectUpdate(_seqT);
+}
+
+void RGBLED::_effectUpdate(uint32_t now)
+{
+  const uint8_t phase = RGBLED_phase8(now - _seqT, _effRate);
+
+  if (_effKind == RGBLED_EFFECT_RAINBOW)
+  {
+    uint8_t r, g, b;
+    RGBLED_hsvToRgb(phase, 255, 255, r, g, b);
+    _showColor(r, g, b);
+    return;
+  }
+
+  uint8_t level;
+  switch (_effKind)
+  {
+    case RGBLED_EFFECT_BREATHE:   level = RGBLED_breathe8(phase);             break;
+    case RGBLED_EFFECT_HEARTBEAT: level = RGBLED_heartbeat8(phase);           break;
+    default:                      level = RGBLED_strobe8(phase, _effParam);   break;
+  }
+#if RGBLED_ENABLE_DITHER
+  if (_ditherOn())
+  {
+    _showColor16(RGBLED_mul88(_r8, level), RGBLED_mul88(_g8, level), RGBLED_mul88(_b8, level));
+    return;
+  }
+#endif
+  _showColor(RGBLED_scale8(_r8, level), RGBLED_scale8(_g8, level), RGBLED_scale8(_b8, level));
+}
+#endif
+
 void RGBLED::red()    { set(true,  false, false); }
 void RGBLED::green()  { set(false, true,  false); }
 void RGBLED::blue()   { set(false, false, true ); }
@@ -277,4 +1024,99 @@ bool RGBLED::_checkParameters(void)
   if (!ok) { lastError = RGBLED_ERR_PARAMS; }
 
   return ok;
-}
\ No newline at end of file
+}
+
+// ##################################################################################
+// Blocking wait:
+
+void RGBLED_waitUntil(uint32_t deadline, RGBLED_WaitHook hook)
+{
+  int32_t left;
+  while ((left = (int32_t)(deadline - (uint32_t)millis())) > 0)
+  {
+    if (hook) hook();
+    else      delay((uint32_t)left);
+  }
+}
+
+// ##################################################################################
+// RGBLED_BlinkTimer Class:
+
+void RGBLED_BlinkTimer::prepare(uint16_t duration_ms, uint32_t number)
+{
+  if (number > 0x7FFFFFFFUL) number = 0x7FFFFFFFUL;  // keep 2*number in 32 bits
+  const uint32_t edges = 2UL * number;              // ON + OFF edges
+  _active  = false;
+  _left    = edges;
+  _delayMs = (uint16_t)(duration_ms / edges);
+  _bonus   = (uint16_t)(duration_ms % edges);       // spread +1ms over the first _bonus edges
+  if (_delayMs == 0 && edges) { _delayMs = 1; }     // avoid zero delay
+}
+
+void RGBLED_BlinkTimer::start(uint32_t now)
+{
+  _next   = now + nextDelay();
+  _active = true;
+}
+
+void RGBLED_BlinkTimer::startInfinite(uint16_t halfPeriod_ms, uint32_t now)
+{
+  _left    = 0;              // sentinel: infinite
+  _delayMs = halfPeriod_ms;  // fixed half-period
+  _bonus   = 0;              // not used in infinite mode
+  _next    = now + _delayMs;
+  _active  = true;
+}
+
+uint32_t RGBLED_BlinkTimer::nextDelay(void)
+{
+  if (_bonus) { --_bonus; return (uint32_t)_delayMs + 1; }
+  return _delayMs;
+}
+
+RGBLED_BlinkTimer::Event RGBLED_BlinkTimer::poll(uint32_t now, uint32_t* firedOut)
+{
+  if (firedOut) *firedOut = 0;
+  if (!_active) return EVENT_NONE;
+  if ((int32_t)(now - _next) < 0) return EVENT_NONE;
+
+  const bool finite = (_left != 0);
+  uint32_t fired = 0;
+
+  // Edges followed by a +1 ms interval: step one at a time (at most `remainder` of them).
+  while (_bonus && (int32_t)(now - _next) >= 0)
+  {
+    ++fired;
+    if (finite) --_left;
+    _next += nextDelay();
+  }
+
+  // Uniform edges: consume every missed edge in one step (catch-up without drift).
+  if ((int32_t)(now - _next) >= 0)
+  {
+    uint32_t n = (uint32_t)(now - _next) / _delayMs + 1;
+    if (finite)
+    {
+      if (n > _left) n = _left;
+      _left -= n;
+    }
+    fired += n;
+    _next += n * _delayMs;
+  }
+
+  if (firedOut) *firedOut = fired;
+
+  // Stop only in FINITE mode, after the last edge
+  if (finite && _left == 0) {
+    _active = false;
+    return EVENT_DONE;
+  }
+  return (fired & 1) ? EVENT_EDGE : EVENT_NONE;
+}
+
+void RGBLED_BlinkTimer::stop(void)
+{
+  _active = false;
+  _left   = 0;
+  _bonus  = 0;
+}
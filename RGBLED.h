@@ -9,8 +9,11 @@
  *  - Turn ON/OFF, toggle, invert channels.  
  *  - Blink in blocking or non-blocking mode (non-blocking uses @ref blinkUpdate).  
  *  - Optional PWM path with 8-bit color and global brightness.  
+ *  - Procedural effects (breathe, heartbeat, strobe, rainbow) evaluated from elapsed time.  
  *
  * @note When PWM is disabled, digital writes (HIGH/LOW) are used (boolean colors).  
+ * @note When PWM is enabled, duties go through the compile-time driver @ref RGBLED_PWM_DRIVER
+ *       (default: @c analogWrite), see RGBLED_Driver.h.
  * @warning When PWM is enabled, availability of @c analogWrite and PWM-capable pins depends
  *          on the board/core (e.g., AVR vs ESP32).
  * @version 1.0
@@ -18,25 +21,115 @@
  */
 
 /**
- * @def RGBLED_ANALOG_WRITE
- * @brief Backend used for PWM writes when PWM mode is enabled.
- *
- * Override this macro *before* including this header if you want to use a different PWM API,
- * e.g. map to @c ledcWrite on ESP32.
- *
- * @code
- *   #define RGBLED_ANALOG_WRITE(pin, val) ledcWrite(myChannelFor(pin), (val))
- *   #include "RGBLED.h"
- * @endcode
+ * @def RGBLED_ENABLE_STATS
+ * @brief Set to 1 to compile hot-path counters and edge-lateness statistics into every LED.
+ * @details Adds @ref RGBLED_Stats to each instance and a few increments to the output and
+ *          update paths. With 0 (default) the counters and their code are compiled out.
+ *          RGBLED.cpp is a separate translation unit, so define it as a build flag
+ *          (e.g. @c -DRGBLED_ENABLE_STATS=1), not only in the sketch.
+ */
+#ifndef RGBLED_ENABLE_STATS
+  #define RGBLED_ENABLE_STATS 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_DITHER
+ * @brief Set to 1 to compile the temporal-dithering color path (see @ref RGBLED::enableDither).
+ * @details Keeps color x brightness in 8.8 fixed point and spreads the fraction over
+ *          successive PWM frames. Adds 17 bytes per LED; with 0 (default) the state and its
+ *          code are compiled out. Like @ref RGBLED_ENABLE_STATS, define it as a build flag.
+ */
+#ifndef RGBLED_ENABLE_DITHER
+  #define RGBLED_ENABLE_DITHER 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_TRACE
+ * @brief Set to 1 to let LEDs record their hardware writes into an @ref RGBLED_Trace.
+ * @details Adds one pointer per LED and a null check per output write; with 0 (default)
+ *          both are compiled out. Define it as a build flag.
  */
-#ifndef RGBLED_ANALOG_WRITE
-  #define RGBLED_ANALOG_WRITE(pin, val) analogWrite((pin), (val))
+#ifndef RGBLED_ENABLE_TRACE
+  #define RGBLED_ENABLE_TRACE 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_FADE
+ * @brief Set to 1 to compile non-blocking color and brightness fades (@ref RGBLED::fadeTo).
+ * @details Adds 27 bytes per LED on AVR. With 0 (default) @c fadeTo, @c fadeBrightness,
+ *          @c isFading and their state are compiled out. Define it as a build flag.
+ */
+#ifndef RGBLED_ENABLE_FADE
+  #define RGBLED_ENABLE_FADE 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_PATTERNS
+ * @brief Set to 1 to compile the PROGMEM pattern sequencer (@ref RGBLED::playPattern).
+ * @details Adds 8 bytes per LED on AVR (4 if effects are enabled too: both share one time
+ *          field). Without @ref RGBLED_ENABLE_FADE, FADE steps switch to their color at once
+ *          and hold it for the fade time. Define it as a build flag.
+ */
+#ifndef RGBLED_ENABLE_PATTERNS
+  #define RGBLED_ENABLE_PATTERNS 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_EFFECTS
+ * @brief Set to 1 to compile procedural effects (@ref RGBLED::breathe and friends).
+ * @details Adds 10 bytes per LED on AVR. The waveform functions of RGBLED_Effects.h stay
+ *          available either way. Define it as a build flag.
+ */
+#ifndef RGBLED_ENABLE_EFFECTS
+  #define RGBLED_ENABLE_EFFECTS 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_COLOR_TABLE
+ * @brief Set to 1 to compile the fused gamma / white-balance table (@ref RGBLED::attachColorTable).
+ * @details Adds 5 bytes per LED on AVR, plus the 256-byte gamma curve in flash. Define it as
+ *          a build flag.
+ */
+#ifndef RGBLED_ENABLE_COLOR_TABLE
+  #define RGBLED_ENABLE_COLOR_TABLE 0
+#endif
+
+/**
+ * @def RGBLED_ENABLE_SOFTPWM
+ * @brief Set to 1 to let LEDs drive their PWM path through an @ref RGBLED_SoftPWM engine.
+ * @details Adds 3 bytes per LED on AVR (@ref RGBLED::attachSoftPWM). The engine class itself
+ *          is always available. Define it as a build flag.
+ */
+#ifndef RGBLED_ENABLE_SOFTPWM
+  #define RGBLED_ENABLE_SOFTPWM 0
 #endif
 
 // ########################################################################################
 // Include libraries:
 
 #include <Arduino.h>
+#include "RGBLED_SoftPWM.h"
+#include "RGBLED_Driver.h"
+#include "RGBLED_Effects.h"
+#include "RGBLED_Trace.h"
+
+/**
+ * @def RGBLED_FAST_GPIO
+ * @brief 1 if the digital (non-PWM) path may write port registers directly.
+ * @details On AVR cores the three pins are resolved once in @ref RGBLED::init into cached
+ *          output-register pointers and bit masks (9 bytes per LED), so a write does no pin
+ *          table lookup. If all three pins share a port, a colour change is a single
+ *          read-modify-write, so the channels switch at the same instant.
+ *          Other cores fall back to @c digitalWrite. Define to 0 before including this header
+ *          to force the @c digitalWrite path.
+ */
+#ifndef RGBLED_FAST_GPIO
+  #if defined(__AVR__) && defined(portOutputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask)
+    #define RGBLED_FAST_GPIO 1
+  #else
+    #define RGBLED_FAST_GPIO 0
+  #endif
+#endif
 
 // ###########################################################################
 // Enumerations & Structures
@@ -81,6 +174,156 @@ struct RGBLED_Params
   uint8_t ACTIVE_MODE = RGBLED_ACTIVE_HIGH; ///< Active mode: 0:LOW, 1:HIGH
 };
 
+/**
+ * @struct RGBLED_ColorTable
+ * @brief Fused per-channel output table: gamma, white balance and brightness in one lookup.
+ * @details Owned by the caller (768 bytes of RAM) and attached with
+ *          @ref RGBLED::attachColorTable. It is rebuilt only when brightness, white balance or
+ *          the gamma flag change; each output update is then three table lookups. One table
+ *          may be shared by several LEDs that use the same calibration and brightness.
+ */
+struct RGBLED_ColorTable
+{
+  uint8_t lut[3][256]; ///< Output value per channel (R,G,B) and 8-bit input.
+};
+
+/**
+ * @brief Scale an 8-bit value by an 8-bit factor: @c x*s/255 without a division.
+ * @param x Value (0..255).
+ * @param s Scale (0 = 0, 255 = unity).
+ * @return @c floor(x*s/255), bit-exact for all inputs.
+ */
+static inline uint8_t RGBLED_scale8(uint8_t x, uint8_t s)
+{
+  const uint16_t t = (uint16_t)x * s;
+  return (uint8_t)((t + 1 + (t >> 8)) >> 8);
+}
+
+/**
+ * @typedef RGBLED_WaitHook
+ * @brief Cooperative wait callback used by blocking blinks instead of @c delay().
+ * @details Called repeatedly until the next edge is due; run other short tasks from it
+ *          (serial handling, watchdog reset, other LEDs' @c update()). It must not start or
+ *          stop a blink on the LED that is currently blocking.
+ */
+typedef void (*RGBLED_WaitHook)(void);
+
+/**
+ * @brief Wait until @c millis() reaches @p deadline.
+ * @param deadline Absolute time in milliseconds.
+ * @param hook     Callback to run while waiting, or nullptr to use @c delay().
+ */
+void RGBLED_waitUntil(uint32_t deadline, RGBLED_WaitHook hook);
+
+#if RGBLED_ENABLE_STATS
+/**
+ * @struct RGBLED_Stats
+ * @brief Hot-path counters and blink-edge lateness (only with @ref RGBLED_ENABLE_STATS).
+ * @details Lateness is @c now - deadline, in ms, measured when a blink edge fires. A growing
+ *          maximum or a heavy upper histogram means the main loop is too slow for the
+ *          requested blink timing.
+ */
+struct RGBLED_Stats
+{
+  uint32_t applyCalls   = 0;  ///< Calls to the color output path (_applyOutputs).
+  uint32_t pinWrites    = 0;  ///< Channel writes actually issued to the hardware.
+  uint32_t elidedWrites = 0;  ///< Channel writes skipped as redundant.
+  uint32_t updateCalls  = 0;  ///< Calls to update()/blinkUpdate() (including idle ones).
+  uint32_t edgesFired   = 0;  ///< Blink edges consumed by update().
+
+  uint32_t latenessMin   = 0xFFFFFFFFUL; ///< Smallest edge lateness (ms); 0xFFFFFFFF if none.
+  uint32_t latenessMax   = 0;            ///< Largest edge lateness (ms).
+  uint32_t latenessSum   = 0;            ///< Sum of lateness samples (mean = sum / count).
+  uint32_t latenessCount = 0;            ///< Number of lateness samples.
+
+  /// Lateness histogram: bucket 0 = 0 ms, bucket k = [2^(k-1), 2^k) ms, last bucket = 64 ms and more.
+  uint16_t latenessHist[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+};
+#endif
+
+// ###########################################################################
+// Blink timing core
+// ###########################################################################
+
+/**
+ * @class RGBLED_BlinkTimer
+ * @brief Timing core of the blink engine (no pin access).
+ * @details Shared by @ref RGBLED and @ref RGBLED_Fixed. It holds the next deadline, the
+ *          half-period, the remainder distribution and the edges left (13 bytes on AVR); the
+ *          owner feeds it the current time through @ref poll and drives its outputs from the
+ *          returned event.
+ */
+class RGBLED_BlinkTimer
+{
+  public:
+
+    /**
+     * @enum Event
+     * @brief Result of @ref poll.
+     */
+    enum Event : uint8_t
+    {
+      EVENT_NONE = 0,  ///< Nothing to do (idle, or next edge not due yet).
+      EVENT_EDGE = 1,  ///< An ON/OFF edge is due: toggle the output.
+      EVENT_DONE = 2   ///< Last edge of a finite sequence: turn the output OFF.
+    };
+
+    /**
+     * @brief Compute finite-mode timing without starting the non-blocking engine.
+     * @param duration_ms Total sequence time in milliseconds (> 0).
+     * @param number      Number of ON/OFF cycles (> 0).
+     * @post  @ref active is false; @ref nextDelay yields the per-edge delays.
+     */
+    void prepare(uint16_t duration_ms, uint32_t number);
+
+    /**
+     * @brief Start the finite sequence computed by @ref prepare in non-blocking mode.
+     * @param now Current time in milliseconds (first edge is ON at @p now).
+     */
+    void start(uint32_t now);
+
+    /**
+     * @brief Start infinite blinking.
+     * @param halfPeriod_ms Time for each ON or OFF interval in milliseconds (> 0).
+     * @param now           Current time in milliseconds.
+     */
+    void startInfinite(uint16_t halfPeriod_ms, uint32_t now);
+
+    /**
+     * @brief Consume the delay of the next edge (blocking mode).
+     * @return Half-period for this edge, including its +1 ms remainder share if any.
+     */
+    uint32_t nextDelay(void);
+
+    /**
+     * @brief Advance the non-blocking sequence.
+     * @details Edges are scheduled from absolute deadlines (start time plus the sum of the
+     *          half-periods), so loop lateness never accumulates. If several edges were missed,
+     *          they are all consumed in this call and the net result is reported.
+     * @param now        Current time in milliseconds.
+     * @param[out] fired Optional: number of edges consumed by this call.
+     * @return Action the owner must apply to its outputs.
+     */
+    Event poll(uint32_t now, uint32_t* fired = nullptr);
+
+    /** @brief Stop blinking and clear the sequence. */
+    void stop(void);
+
+    /** @brief True while a non-blocking sequence is in progress. */
+    bool active(void) const { return _active; }
+
+    /** @brief Absolute time of the next edge (meaningful only while @ref active). */
+    uint32_t deadline(void) const { return _next; }
+
+  private:
+
+    uint32_t _next    = 0;     ///< Absolute time of the next edge.
+    uint32_t _left    = 0;     ///< Edges left in a finite sequence (0 = infinite).
+    uint16_t _delayMs = 0;     ///< Base half-period in ms.
+    uint16_t _bonus   = 0;     ///< Intervals still to be stretched by +1 ms (exact total duration).
+    bool     _active  = false; ///< True if non-blocking blink in progress.
+};
+
 // ###########################################################################
 // Class Definition
 // ###########################################################################
@@ -214,6 +457,39 @@ class RGBLED
     void getColor(bool &r, bool &g, bool &b) const;
 
     bool getInitFlag(void) { return _initFlag;};
+
+#if RGBLED_ENABLE_TRACE
+    /**
+     * @brief Record every hardware write (time, pin, value) into @p trace, or stop with @c nullptr.
+     * @details Every requested channel write is recorded. Writes skipped by redundant-write
+     *          elision carry @c elided = true; the rest is exactly what reaches the driver,
+     *          software PWM engine or pins. Replay with RGBLED_TraceReplay.h.
+     * @param trace Caller-owned buffer; may be shared by several LEDs.
+     */
+    void attachTrace(RGBLED_Trace* trace) { _trace = trace; }
+#endif
+
+#if RGBLED_ENABLE_STATS
+    /**
+     * @brief Copy the statistics block (cheap; safe to call from loop for periodic logging).
+     * @param[out] out Snapshot of the counters.
+     */
+    void getStats(RGBLED_Stats &out) const { out = _stats; out.elidedWrites = _elidedWrites; }
+
+    /** @brief Reset all statistics, including @ref elidedWrites. */
+    void resetStats(void) { _stats = RGBLED_Stats(); _elidedWrites = 0; }
+#endif
+
+    /**
+     * @brief Number of channel writes skipped because the pin already held the value.
+     * @details Every output update resolves three channel values (after brightness and
+     *          active-mode inversion) and only writes the channels that changed. Always
+     *          counted; @ref getStats reports the same number.
+     */
+    uint32_t elidedWrites(void) const { return _elidedWrites; }
+
+    /** @brief Reset the @ref elidedWrites counter to zero. */
+    void resetElidedWrites(void) { _elidedWrites = 0; }
     
     // --------------------------------------------------------------------------
     // PWM / 8-bit color (optional)
@@ -230,17 +506,111 @@ class RGBLED
      */
     void setRGB(uint8_t r, uint8_t g, uint8_t b);
 
+    /**
+     * @brief Set color from hue, saturation and value (integer conversion, no floats).
+     * @param h Hue (0..255 = one full turn; 0 red, 85 green, 170 blue).
+     * @param s Saturation (0 = white/grey, 255 = pure hue).
+     * @param v Value (0..255).
+     * @sa    @ref RGBLED_hsvToRgb, @ref RGBLED_hsv16ToRgb for finer hue steps.
+     */
+    void setHSV(uint8_t h, uint8_t s, uint8_t v);
+
+    /**
+     * @brief Set a white of the given color temperature.
+     * @param kelvin Temperature in K (1000..12008; clamped). 2700 warm, 6500 daylight.
+     * @param v      Intensity (0..255).
+     * @note  The table gives the light color, not a calibration of this LED; combine with
+     *        @ref setWhiteBalance for accurate whites.
+     */
+    void setKelvin(uint16_t kelvin, uint8_t v = 255);
+
     /**
      * @brief Enable/disable PWM path. If disabled, uses digital writes (ON/OFF).
      * @param en true to enable PWM; false to disable.
+     * @note  Leaving PWM mode rewrites the pins once through @c digitalWrite so the core
+     *        detaches the PWM timers before the direct-port path takes over.
      */
-    void enablePWM(bool en) { _pwmEnabled = en; }
-    
+    void enablePWM(bool en);
+
+    /**
+     * @brief Access the PWM output driver (@ref RGBLED_PWM_DRIVER), e.g. to configure it.
+     * @details @ref init binds the driver to the three pins before the first write.
+     */
+    RGBLED_PWM_DRIVER& driver(void) { return _driver; }
+
+#if RGBLED_ENABLE_SOFTPWM
+    /**
+     * @brief Route the PWM path through a shared software-PWM engine instead of the driver.
+     * @details Registers the three pins as engine channels. Use for pins without hardware PWM;
+     *          @ref enablePWM still selects between PWM and digital writes.
+     * @pre   @ref init must have succeeded.
+     * @param engine Engine whose @c isr() is called from a timer interrupt.
+     * @retval true  Channels registered.
+     * @retval false Not initialized, engine full, or port registers unavailable on this core.
+     */
+    bool attachSoftPWM(RGBLED_SoftPWM& engine);
+#endif
+
     /**
      * @brief Global brightness (0..255), only affects PWM path.
      * @param b Brightness scale (0 = off, 255 = full).
+     * @note  Applied to the LED immediately if it is currently ON.
+     */
+    void setBrightness(uint8_t b);
+
+#if RGBLED_ENABLE_COLOR_TABLE
+    /**
+     * @brief Attach (or detach with @c nullptr) a fused output table.
+     * @details The table is rebuilt from the current gamma flag, white balance and brightness,
+     *          and replaces the per-update brightness multiply with three lookups.
+     * @param table Caller-owned table storage; must outlive this object or be detached.
+     * @sa    @ref setWhiteBalance, @ref enableGamma
+     */
+    void attachColorTable(RGBLED_ColorTable* table);
+
+    /**
+     * @brief Per-channel white-balance gains (255 = unity). Used by the attached color table.
+     * @param rGain Red gain.
+     * @param gGain Green gain.
+     * @param bGain Blue gain.
+     */
+    void setWhiteBalance(uint8_t rGain, uint8_t gGain, uint8_t bGain);
+
+    /**
+     * @brief Enable/disable gamma 2.2 correction (PROGMEM curve). Used by the attached color table.
+     * @param en true for perceptual dimming; false for linear output.
+     */
+    void enableGamma(bool en);
+#endif
+
+#if RGBLED_ENABLE_DITHER
+    /**
+     * @brief Enable temporal dithering on the PWM path, or disable it with 0.
+     * @details Color and brightness are combined in 8.8 fixed point once per change. Every
+     *          frame adds the fraction of each channel to an 8-bit error accumulator and
+     *          outputs the integer part plus the carry, so the duty averaged over 256 frames
+     *          equals the exact value (a few adds per channel, no multiply or divide).
+     *          Color fades and effects keep their fraction, so slow fades and deep dims do
+     *          not step visibly.
+     * @param frame_ms Frame interval in ms (1..255); 0 turns dithering off.
+     * @note  Frames are emitted by @ref update, which must run at least every @p frame_ms.
+     *        Not applied on the digital path or with a color table attached (8-bit lookups).
+     *        Fades and effects keep their fraction only if they are compiled in.
+     */
+    void enableDither(uint8_t frame_ms);
+
+    /** @brief Frame interval set by @ref enableDither (0 = off). */
+    uint8_t ditherInterval(void) const { return _ditherFrameMs; }
+
+    /**
+     * @brief Set a 16-bit color (0..65535 per channel); the fraction below 8 bits is dithered.
+     * @details Without active dithering the color shows truncated to 8 bits.
+     * @param r Red   intensity (0..65535)
+     * @param g Green intensity (0..65535)
+     * @param b Blue  intensity (0..65535)
      */
-    void setBrightness(uint8_t b) { _brightness = b; }
+    void setRGB16(uint16_t r, uint16_t g, uint16_t b);
+#endif
 
     // -----------------------------------------------------------------------
     // Blink utilities
@@ -258,8 +628,17 @@ class RGBLED
      *
      * @note In non-blocking mode, call @ref blinkUpdate() regularly in @c loop().
      * @note Use @ref stopBlink() to end infinite blinking.
+     * @note Blocking mode waits on absolute deadlines through @ref setWaitHook (or @c delay()
+     *       if no hook is set), so the total duration stays exact either way.
+     */
+    void blink(uint16_t duration, uint32_t number, bool blockingMode = true);
+
+    /**
+     * @brief Install a cooperative wait callback for blocking blinks.
+     * @param hook Callback run repeatedly while a blocking blink waits; nullptr restores
+     *             plain @c delay().
      */
-    void blink(uint16_t duration, uint8_t number, bool blockingMode = true);
+    void setWaitHook(RGBLED_WaitHook hook) { _waitHook = hook; }
 
     /**
      * @brief Stop non-blocking blink immediately.
@@ -271,7 +650,7 @@ class RGBLED
      * @brief Get blinking status (only meaningful in non-blocking mode).
      * @return true if blinking is in progress; false if finished or idle.
      */
-    bool isBlinking(void) {return _blinkActive;};
+    bool isBlinking(void) {return _blink.active();};
 
     /**
      * @brief Progress blinking sequence in non-blocking mode.
@@ -279,6 +658,144 @@ class RGBLED
      */
     void blinkUpdate(void);
 
+    /**
+     * @brief Progress all time-based behaviour (blinking, fading, patterns, effects) in non-blocking mode.
+     * @details Reads @c millis() once. @ref blinkUpdate is equivalent; either may be called.
+     */
+    void update(void);
+
+    /**
+     * @brief Progress all time-based behaviour using a caller-supplied clock.
+     * @param now Current time in milliseconds (same timebase as @c millis()).
+     * @sa    @ref nextDeadlineMs
+     */
+    void update(uint32_t now);
+
+    /**
+     * @brief Absolute time of the next scheduled state change.
+     * @details Lets a scheduler or sleep routine wake exactly when needed instead of polling.
+     *          A running fade or effect is always due (it changes every millisecond at most),
+     *          so the returned time may lie in the past. With dithering, the next dither
+     *          frame counts as well while a fraction or an effect is shown.
+     * @param[out] deadline Time in @c millis() units; untouched when idle.
+     * @retval true  A blink edge, pattern step or fade step is pending.
+     * @retval false Idle: nothing changes until the next API call.
+     */
+    bool nextDeadlineMs(uint32_t &deadline) const;
+
+#if RGBLED_ENABLE_FADE
+    // -----------------------------------------------------------------------
+    // Fading (non-blocking, RGBLED_ENABLE_FADE)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Fade from the displayed color to an 8-bit target color.
+     * @param r           Target red   intensity (0..255)
+     * @param g           Target green intensity (0..255)
+     * @param b           Target blue  intensity (0..255)
+     * @param duration_ms Fade time in ms; 0 behaves like @ref setRGB.
+     * @note  Progressed by @ref update / @ref blinkUpdate. Values are computed from elapsed
+     *        time with a rounded-up 2^32/duration reciprocal (progress in 1/65536 steps, no
+     *        division per tick), so a slow loop does not stretch the fade and the last tick
+     *        lands within one count of the target. A fade
+     *        started while the LED is OFF begins from black. @ref set and @ref setRGB cancel it.
+     */
+    void fadeTo(uint8_t r, uint8_t g, uint8_t b, uint16_t duration_ms);
+
+    /**
+     * @brief Fade the global brightness to a target value.
+     * @param target      Target brightness (0..255).
+     * @param duration_ms Fade time in ms; 0 behaves like @ref setBrightness.
+     * @note  With a color table attached, each brightness step rebuilds the table.
+     *        @ref setBrightness cancels the fade.
+     */
+    void fadeBrightness(uint8_t target, uint16_t duration_ms);
+
+    /** @brief True while a color or brightness fade is in progress. */
+    bool isFading(void) const { return (_fadeFlags & 0x03) != 0; }  // color or brightness bit
+#endif
+
+#if RGBLED_ENABLE_PATTERNS
+    // -----------------------------------------------------------------------
+    // Patterns (non-blocking, RGBLED_ENABLE_PATTERNS)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Start interpreting a byte-coded pattern stored in flash.
+     * @param pattern PROGMEM pattern built with the @c RGBLED_P_* macros of RGBLED_Pattern.h
+     *                (validate it with @c RGBLED_patternValid).
+     * @note  Progressed by @ref update / @ref blinkUpdate. Stops a running non-blocking blink.
+     *        Timing uses absolute deadlines, so holds do not drift with loop lateness.
+     */
+    void playPattern(const uint8_t* pattern);
+
+    /**
+     * @brief Stop the running pattern.
+     * @param turnOff If true, forces LED OFF; otherwise leaves current state as-is.
+     */
+    void stopPattern(bool turnOff = true);
+
+    /** @brief True while a pattern is running. */
+    bool isPlaying(void) const { return _patBase != nullptr; }
+#endif
+
+#if RGBLED_ENABLE_EFFECTS
+    // -----------------------------------------------------------------------
+    // Procedural effects (non-blocking, RGBLED_ENABLE_EFFECTS)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Breathe the current color: smooth rise and fall once per period.
+     * @param period_ms Period in ms; 0 stops the effect.
+     * @note  Effects are pure functions of the time since @ref effectOrigin, progressed by
+     *        @ref update. They stop a running blink or pattern. Without a color set, white
+     *        is used. @ref set, @ref setRGB and @ref fadeTo change the color being modulated;
+     *        @ref off, @ref blink and @ref playPattern stop the effect.
+     */
+    void breathe(uint16_t period_ms);
+
+    /**
+     * @brief Double pulse of the current color, then rest, once per period.
+     * @param period_ms Period in ms (about 1000 looks natural); 0 stops the effect.
+     */
+    void heartbeat(uint16_t period_ms = 1000);
+
+    /**
+     * @brief Flash the current color: ON for @p duty/256 of each period.
+     * @param period_ms Period in ms; 0 stops the effect.
+     * @param duty      ON fraction of the period (1..255).
+     */
+    void strobe(uint16_t period_ms, uint8_t duty = 32);
+
+    /**
+     * @brief Cycle the hue through the full color wheel once per period.
+     * @param period_ms Period in ms; 0 stops the effect.
+     * @note  Brightness, white balance and gamma still apply.
+     */
+    void rainbow(uint16_t period_ms);
+
+    /**
+     * @brief Stop the running effect.
+     * @param turnOff If true, forces LED OFF; otherwise shows the cached color.
+     */
+    void stopEffect(bool turnOff = true);
+
+    /** @brief Effect currently running (@ref RGBLED_EFFECT_NONE if none). */
+    RGBLED_EffectKind effect(void) const { return (RGBLED_EffectKind)_effKind; }
+
+    /**
+     * @brief Move the time origin of the running effect (seek / synchronize).
+     * @details Two LEDs running the same effect and period with the same origin are in phase;
+     *          an origin @c d ms earlier seeks @c d ms ahead. Starting an effect sets the
+     *          origin to @c millis(). Ignored while no effect runs.
+     * @param t0 Origin in @c millis() units.
+     */
+    void setEffectOrigin(uint32_t t0) { if (_effKind) _seqT = t0; }
+
+    /** @brief Time origin of the running effect in @c millis() units. */
+    uint32_t effectOrigin(void) const { return _seqT; }
+#endif
+
     // -----------------------------------------------------------------------
     // Color presets
     // -----------------------------------------------------------------------
@@ -310,29 +827,108 @@ class RGBLED
     // Internal state
     // -----------------------------------------------------------------------
 
-    uint8_t _onLevel = 1; ///< Logical ON level for pins (1 for CC, 0 for CA).
+    // Layout: 32-bit fields, then pointers, then 16/8-bit fields and packed flags, so 32-bit
+    // cores need no padding. Optional features only add their own state; the per-instance
+    // size is checked in RGBLED.cpp and extras/host/test/test_sizeof.cpp.
+
+    // ---------- Timing ----------
+    RGBLED_BlinkTimer _blink;                ///< Blink timing (blocking and non-blocking).
+#if RGBLED_ENABLE_FADE
+    uint32_t _fadeT0 = 0;                    ///< Start of the earlier running fade (the other starts _fadeOff ms later).
+    uint32_t _fadeRecip = 0;                 ///< ceil(2^32 / color fade duration): progress per ms.
+    uint32_t _briRecip = 0;                  ///< ceil(2^32 / brightness fade duration).
+#endif
+#if RGBLED_ENABLE_PATTERNS || RGBLED_ENABLE_EFFECTS
+    uint32_t _seqT = 0;                      ///< Pattern: time of the next instruction. Effect: time origin.
+#endif
+#if RGBLED_ENABLE_EFFECTS
+    uint32_t _effRate = 0;                   ///< Effect phase rate (2^32 / period).
+#endif
+#if RGBLED_ENABLE_DITHER
+    uint32_t _ditherNext = 0;                ///< Time of the next dither frame.
+#endif
+
+    uint32_t _elidedWrites = 0;              ///< Channel writes skipped as redundant.
 
-    bool _redDesired   = false; ///< Desired state of red channel.
-    bool _greenDesired = false; ///< Desired state of green channel.
-    bool _blueDesired  = false; ///< Desired state of blue channel.
+    // ---------- Pointers ----------
+    RGBLED_WaitHook _waitHook = nullptr;     ///< Wait callback for blocking blinks (nullptr = delay).
+#if RGBLED_ENABLE_PATTERNS
+    const uint8_t* _patBase = nullptr;       ///< Running PROGMEM pattern, or nullptr.
+#endif
+#if RGBLED_ENABLE_COLOR_TABLE
+    RGBLED_ColorTable* _colorTable = nullptr;///< Attached output table, or nullptr for plain scaling.
+#endif
+#if RGBLED_ENABLE_SOFTPWM
+    RGBLED_SoftPWM* _softPwm = nullptr;      ///< Attached software PWM engine, or nullptr.
+#endif
+#if RGBLED_ENABLE_TRACE
+    RGBLED_Trace* _trace = nullptr;          ///< Attached write recorder, or nullptr.
+#endif
+    RGBLED_PWM_DRIVER _driver;               ///< PWM output driver (default: three pin numbers).
+#if RGBLED_FAST_GPIO
+    volatile uint8_t* _outR = nullptr;       ///< Output register of the red pin.
+    volatile uint8_t* _outG = nullptr;       ///< Output register of the green pin.
+    volatile uint8_t* _outB = nullptr;       ///< Output register of the blue pin.
+#endif
 
-    bool _isOn = false;       ///< True if LED is currently ON with cached color.
-    bool _initFlag = false;   ///< True after successful init().
+    // ---------- 16-bit fields ----------
+#if RGBLED_ENABLE_FADE
+    uint16_t _fadeDuration = 0;              ///< Color fade length in ms.
+    uint16_t _briDuration = 0;               ///< Brightness fade length in ms.
+    uint16_t _fadeOff = 0;                   ///< Start of the later fade, ms after _fadeT0.
+#endif
+#if RGBLED_ENABLE_DITHER
+    uint16_t _ditherTarget[3] = {0, 0, 0};   ///< Scaled output per channel, 8.8 fixed point.
+#endif
 
-    // Non-blocking blink state
-    bool     _blinkActive   = false; ///< True if non-blocking blink in progress.
-    uint8_t  _blinkNumber   = 0;     ///< Number of requested cycles.
-    uint8_t  _blinkEdgeCnt  = 0;     ///< Counts ON/OFF edges.
-    uint32_t _blinkDelayMs  = 0;     ///< Base half-period in ms.
-    uint16_t _blinkRemainder = 0;    ///< Edges that get +1 ms to hit exact total duration.
-    uint32_t _tRef          = 0;     ///< Last toggle timestamp.
+    // ---------- Color (single cache; boolean channel states are derived from it) ----------
+    uint8_t _r8 = 0, _g8 = 0, _b8 = 0;       ///< Cached 8-bit desired color.
+    uint8_t _brightness = 255;               ///< 0..255 scales PWM output.
+    uint8_t _lastR = 0, _lastG = 0, _lastB = 0; ///< Last value written per channel (duty or level).
+#if RGBLED_ENABLE_COLOR_TABLE
+    uint8_t _gainR = 255, _gainG = 255, _gainB = 255; ///< White-balance gains (255 = unity).
+#endif
+#if RGBLED_FAST_GPIO
+    uint8_t _maskR = 0, _maskG = 0, _maskB = 0; ///< Bit masks of the pins in their ports.
+#endif
 
-    uint32_t _currentDelay  = 0;     ///< Half-period used for the *next* edge.
+    // ---------- Fading / patterns / effects / software PWM ----------
+#if RGBLED_ENABLE_FADE
+    uint8_t _fadeFlags = 0;                  ///< RGBLED_FADE_* bits of running fades.
+    uint8_t _fadeFrom[3] = {0, 0, 0};        ///< Color at fade start (R,G,B).
+    uint8_t _fadeTarget[3] = {0, 0, 0};      ///< Color at fade end (R,G,B).
+    uint8_t _briFrom = 0, _briTarget = 0;    ///< Brightness at fade start / end.
+#endif
+#if RGBLED_ENABLE_PATTERNS
+    uint8_t _patPC = 0;                      ///< Byte offset of the next pattern instruction.
+    uint8_t _patLoop = 0;                    ///< Remaining passes of the active REPEAT (0 = none).
+#endif
+#if RGBLED_ENABLE_SOFTPWM
+    uint8_t _softCh = 0;                     ///< Engine channel of red (green/blue follow).
+#endif
+#if RGBLED_ENABLE_EFFECTS
+    uint8_t _effKind = RGBLED_EFFECT_NONE;   ///< Running RGBLED_EffectKind.
+    uint8_t _effParam = 0;                   ///< Effect parameter (strobe duty).
+#endif
+#if RGBLED_ENABLE_DITHER
+    uint8_t _colorLo[3] = {0, 0, 0};         ///< Fraction of the cached color (8.8 with _r8/_g8/_b8).
+    uint8_t _ditherAcc[3] = {0, 0, 0};       ///< Per-channel error accumulators.
+    uint8_t _ditherFrameMs = 0;              ///< Dither frame interval (0 = off).
+#endif
 
-    // ---------- Optional PWM / brightness ----------
-    bool    _pwmEnabled   = false;
-    uint8_t _brightness   = 255;     ///< 0..255 scales PWM output.
-    uint8_t _r8 = 0, _g8 = 0, _b8 = 0; ///< cached 8-bit desired color
+    // ---------- Packed flags (initialized in the constructor) ----------
+    bool _onLevel    : 1;  ///< Logical ON level for pins (1 for CC, 0 for CA).
+    bool _isOn       : 1;  ///< True if LED is currently ON with cached color.
+    bool _initFlag   : 1;  ///< True after successful init().
+    bool _pwmEnabled : 1;  ///< PWM path selected.
+    bool _gamma      : 1;  ///< Apply gamma curve when building the color table.
+    bool _lastValid  : 1;  ///< True if _lastR/_lastG/_lastB match the pins.
+    bool _fastGpio   : 1;  ///< True once the pins are known to have port registers.
+    bool _samePort   : 1;  ///< True if all three pins share one output port.
+
+#if RGBLED_ENABLE_STATS
+    RGBLED_Stats _stats;                     ///< Opt-in hot-path statistics.
+#endif
 
     // -----------------------------------------------------------------------
     // Internal helpers
@@ -346,8 +942,165 @@ class RGBLED
 
     /**
      * @brief Apply current cached color to hardware according to wiring mode and PWM flag.
+     * @details While an effect runs, shows the effect frame for the current time instead.
      */
     void _applyOutputs();
 
+    /**
+     * @brief Scale an 8-bit color (brightness / table), map it to the wiring and write it.
+     */
+    void _showColor(uint8_t r, uint8_t g, uint8_t b);
+
+    /** @brief True if the cached color (including its fraction) is not black. */
+    bool _hasColor(void) const
+    {
+#if RGBLED_ENABLE_DITHER
+      return (_r8 | _g8 | _b8 | _colorLo[0] | _colorLo[1] | _colorLo[2]) != 0;
+#else
+      return (_r8 | _g8 | _b8) != 0;
+#endif
+    }
+
+    /** @brief Drop the fraction of the cached color (after an 8-bit assignment). */
+    void _clearColorLo(void)
+    {
+#if RGBLED_ENABLE_DITHER
+      _colorLo[0] = _colorLo[1] = _colorLo[2] = 0;
+#endif
+    }
+
+    /** @brief True while an effect owns the output (always false without effects compiled in). */
+    bool _effectOn(void) const
+    {
+#if RGBLED_ENABLE_EFFECTS
+      return _effKind != RGBLED_EFFECT_NONE;
+#else
+      return false;
+#endif
+    }
+
+    /** @brief True if outputs go through the dither path (compiled in, enabled, plain PWM scaling). */
+    bool _ditherOn(void) const
+    {
+#if RGBLED_ENABLE_DITHER && RGBLED_ENABLE_COLOR_TABLE
+      return _ditherFrameMs && _pwmEnabled && !_colorTable;
+#elif RGBLED_ENABLE_DITHER
+      return _ditherFrameMs && _pwmEnabled;
+#else
+      return false;
+#endif
+    }
+
+    /** @brief True if @ref update has a blink, fade, pattern or effect to progress. */
+    bool _timedBusy(void) const
+    {
+      return _blink.active() || _effectOn()
+#if RGBLED_ENABLE_FADE
+             || isFading()
+#endif
+#if RGBLED_ENABLE_PATTERNS
+             || _patBase
+#endif
+             ;
+    }
+
+#if RGBLED_ENABLE_DITHER
+    /** @brief True if @ref update has dither frames to emit (a lit fraction or an effect). */
+    bool _ditherPending(void) const
+    {
+      return _ditherOn() && (_effectOn() ||
+             (_isOn && (uint8_t)(_ditherTarget[0] | _ditherTarget[1] | _ditherTarget[2]) != 0));
+    }
+
+    /**
+     * @brief Scale an 8.8 color by brightness into the dither targets and show them at once.
+     * @details Shows the frame @ref update will emit next, without advancing the
+     *          accumulators, so color changes between frames do not skew the average.
+     */
+    void _showColor16(uint16_t r, uint16_t g, uint16_t b);
+
+    /**
+     * @brief Emit one dithered frame: integer part plus accumulator carry per channel.
+     * @param advance True on the frame clock of @ref update: keep the new accumulators.
+     */
+    void _ditherFrame(bool advance);
+#endif
+
+    /**
+     * @brief Write physical channel values, skipping channels that already hold them.
+     * @param r Red   value (PWM duty, or HIGH/LOW on the digital path).
+     * @param g Green value (PWM duty, or HIGH/LOW on the digital path).
+     * @param b Blue  value (PWM duty, or HIGH/LOW on the digital path).
+     */
+    void _writeOutputs(uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * @brief Write raw pin levels on the digital path.
+     * @details Uses the port registers when available (one store if all pins share a port),
+     *          otherwise one @c digitalWrite per changed channel.
+     * @param r     Level for the red pin (HIGH/LOW).
+     * @param g     Level for the green pin (HIGH/LOW).
+     * @param b     Level for the blue pin (HIGH/LOW).
+     * @param dirty Bit 0/1/2 set for red/green/blue channels that changed.
+     */
+    void _writeDigital(uint8_t r, uint8_t g, uint8_t b, uint8_t dirty);
+
+#if RGBLED_ENABLE_FADE
+    /**
+     * @brief Advance running fades to time @p now.
+     */
+    void _fadeUpdate(uint32_t now);
+
+    /**
+     * @brief Start time of the fade selected by @p flag (RGBLED_FADE_COLOR / _BRIGHTNESS).
+     */
+    uint32_t _fadeStart(uint8_t flag) const;
+
+    /**
+     * @brief Record @p t as the start of fade @p flag, re-basing the shared start if needed.
+     * @details Both starts are kept as one 32-bit time plus a 16-bit offset. Fades last at
+     *          most 65535 ms, so starts further apart are clamped: the fade that is clamped has
+     *          already ended in either representation.
+     */
+    void _setFadeStart(uint8_t flag, uint32_t t);
+#endif
+
+#if RGBLED_ENABLE_PATTERNS
+    /**
+     * @brief Run pattern instructions that are due at time @p now.
+     */
+    void _patternUpdate(uint32_t now);
+#endif
+
+#if RGBLED_ENABLE_EFFECTS
+    /**
+     * @brief Start effect @p kind with the given period (0 stops any effect).
+     */
+    void _startEffect(uint8_t kind, uint16_t period_ms, uint8_t param);
+
+    /**
+     * @brief Show the effect frame for time @p now.
+     */
+    void _effectUpdate(uint32_t now);
+#endif
+
+    /**
+     * @brief Store a new brightness, rebuild the table and refresh outputs (no fade cancel).
+     */
+    void _applyBrightness(uint8_t b);
+
+#if RGBLED_ENABLE_COLOR_TABLE
+    /**
+     * @brief Refill the attached color table (no-op if none is attached).
+     */
+    void _rebuildColorTable(void);
+#endif
+
+    /**
+     * @brief Resolve the pins into cached port registers and masks, and check whether they
+     *        share one port (no-op without fast GPIO).
+     */
+    void _resolvePorts(void);
+
 };
 
@@ -0,0 +1,479 @@
+#pragma once
+
+/**
+ * @file RGBLEDGroup.h
+ * @brief Batched manager for many @ref RGBLED instances.
+ * @details
+ *  - Colours, blink deadlines and flags live in contiguous arrays (structure-of-arrays).
+ *  - @ref RGBLEDGroup::update reads @c millis() once and returns immediately until the earliest
+ *    deadline has passed; then it walks only the list of blinking LEDs.
+ *  - Group-wide operations: all-off, global brightness and synchronized blink.
+ *  - Optional power budget: the group keeps a running estimate of the supply current and
+ *    lowers the brightness of all members just enough to stay within it.
+ *  - Stream sink (@ref stageRGB / @ref showRange): pixels go straight into the colour cache
+ *    and are shown when the range is committed. With @p STAGED = true they are held in a
+ *    3-byte-per-member staging copy instead, so a frame that is never committed leaves no
+ *    trace at all (see RGBLED_Stream.h).
+ *
+ * @code
+ *   RGBLED a, b, c;
+ *   RGBLEDGroup<8> group;
+ *
+ *   void setup() {
+ *     // ... configure and init() a, b, c ...
+ *     group.add(a); group.add(b); group.add(c);
+ *     group.setRGB(0, 255, 0, 0);
+ *     group.blink(0, 250, 0);          // LED 0: 250 ms half-period, forever
+ *   }
+ *   void loop() { group.update(); }
+ * @endcode
+ *
+ * @note Blinking managed by the group is independent of @ref RGBLED::blink; do not run both
+ *       on the same LED.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+// ###########################################################################
+// Staging storage
+// ###########################################################################
+
+/**
+ * @struct RGBLEDGroup_Staging
+ * @brief Staging copy of the colours of an @ref RGBLEDGroup created with @c STAGED = true.
+ */
+template <uint8_t N, bool STAGED>
+struct RGBLEDGroup_Staging
+{
+  uint8_t _stageR[N], _stageG[N], _stageB[N]; ///< Colours written by stageRGB(), committed by showRange().
+
+  /// Keep a colour; true = held here, not in the cache.
+  bool _stagePut(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+  {
+    _stageR[i] = r; _stageG[i] = g; _stageB[i] = b;
+    return true;
+  }
+
+  /// Fetch a held colour; true = it must be committed to the cache.
+  bool _stageGet(uint8_t i, uint8_t& r, uint8_t& g, uint8_t& b) const
+  {
+    r = _stageR[i]; g = _stageG[i]; b = _stageB[i];
+    return true;
+  }
+};
+
+/// Unstaged groups: no storage (empty base), pixels go straight into the colour cache.
+template <uint8_t N>
+struct RGBLEDGroup_Staging<N, false>
+{
+  bool _stagePut(uint8_t, uint8_t, uint8_t, uint8_t) { return false; }
+  bool _stageGet(uint8_t, uint8_t&, uint8_t&, uint8_t&) const { return false; }
+};
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLEDGroup
+ * @brief Fixed-capacity container that drives up to @p N LEDs from one update call.
+ * @tparam N      Maximum number of LEDs (1..255).
+ * @tparam STAGED Hold streamed pixels in a staging copy (3*N bytes) until @ref showRange.
+ */
+template <uint8_t N, bool STAGED = false>
+class RGBLEDGroup : private RGBLEDGroup_Staging<N, STAGED>
+{
+    static_assert(N > 0, "RGBLEDGroup: capacity must be at least 1");
+
+  public:
+
+    /// Index value returned by @ref add when the group is full.
+    static constexpr int16_t INVALID_INDEX = -1;
+
+    // -----------------------------------------------------------------------
+    // Membership
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Add an initialized LED to the group.
+     * @details The LED takes the group's applied brightness (@ref setBrightness and the power
+     *          limit).
+     * @param led LED object; must outlive the group.
+     * @return Index of the LED in the group, or @ref INVALID_INDEX if the group is full.
+     */
+    int16_t add(RGBLED& led)
+    {
+      if (_count >= N) return INVALID_INDEX;
+
+      const uint8_t i = _count++;
+      _leds[i]       = &led;
+      _r[i] = _g[i] = _b[i] = 0;
+      this->_stagePut(i, 0, 0, 0);
+      _halfPeriod[i] = 0;
+      _cyclesLeft[i] = 0;
+      _deadline[i]   = 0;
+      _flags[i]      = 0;
+      led.setBrightness(_appliedBrightness);
+      return i;
+    }
+
+    /** @brief Number of LEDs in the group. */
+    uint8_t size(void) const { return _count; }
+
+    /** @brief Number of LEDs currently blinking under group control. */
+    uint8_t activeCount(void) const { return _activeCount; }
+
+    // -----------------------------------------------------------------------
+    // Per-LED control
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Set the colour of one LED and show it (unless it is in a blink OFF phase).
+     * @param i Index returned by @ref add.
+     * @param r Red   intensity (0..255)
+     * @param g Green intensity (0..255)
+     * @param b Blue  intensity (0..255)
+     */
+    void setRGB(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if (i >= _count) return;
+      _setCache(i, r, g, b);
+      _applyLimit();
+      if (!(_flags[i] & FLAG_BLINK) || (_flags[i] & FLAG_PHASE_ON)) _leds[i]->setRGB(r, g, b);
+    }
+
+    /**
+     * @brief Set the colour of one LED from hue, saturation and value (integer conversion).
+     * @details For hue sweeps over the whole group, e.g. @c setHSV(i, base + i * 16, 255, 255).
+     * @param i Index returned by @ref add.
+     */
+    void setHSV(uint8_t i, uint8_t h, uint8_t s, uint8_t v)
+    {
+      uint8_t r, g, b;
+      RGBLED_hsvToRgb(h, s, v, r, g, b);
+      setRGB(i, r, g, b);
+    }
+
+    /**
+     * @brief Set the colour of one LED without showing it (see @ref showRange).
+     * @details Lets a producer such as @ref RGBLED_StreamDecoder fill a whole range and show
+     *          it only after validating it. By default the colour goes straight into the
+     *          colour cache (and the power estimate); it is not output, but a blink ON edge
+     *          of that LED shows it. With @p STAGED = true it goes to the staging copy, so a
+     *          range that is never committed has no effect at all.
+     * @param i Index returned by @ref add.
+     */
+    void stageRGB(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if (i >= _count) return;
+      if (!this->_stagePut(i, r, g, b)) _setCache(i, r, g, b);
+    }
+
+    /**
+     * @brief Show the colours of LEDs @p first .. @p first + @p count - 1 set with @ref stageRGB.
+     * @details With @p STAGED = true the staged colours are committed to the colour cache
+     *          first. LEDs in a blink OFF phase pick the colour up at their next ON edge.
+     */
+    void showRange(uint8_t first, uint8_t count)
+    {
+      uint8_t end = (uint8_t)(first + count);
+      if (end > _count || end < first) end = _count;
+      uint8_t r, g, b;
+      for (uint8_t i = first; i < end; ++i)
+      {
+        if (this->_stageGet(i, r, g, b)) _setCache(i, r, g, b);
+      }
+
+      _applyLimit();
+      for (uint8_t i = first; i < end; ++i)
+      {
+        if (!(_flags[i] & FLAG_BLINK) || (_flags[i] & FLAG_PHASE_ON)) _leds[i]->setRGB(_r[i], _g[i], _b[i]);
+      }
+    }
+
+    /**
+     * @brief Start blinking one LED.
+     * @param i             Index returned by @ref add.
+     * @param halfPeriod_ms Time for each ON or OFF interval (> 0).
+     * @param cycles        Number of ON/OFF cycles; 0 blinks forever.
+     */
+    void blink(uint8_t i, uint16_t halfPeriod_ms, uint16_t cycles)
+    {
+      if (i >= _count || halfPeriod_ms == 0) return;
+      _startBlink(i, halfPeriod_ms, cycles, millis());
+    }
+
+    /**
+     * @brief Stop blinking one LED.
+     * @param i       Index returned by @ref add.
+     * @param turnOff If true, forces the LED OFF; otherwise shows its colour.
+     */
+    void stopBlink(uint8_t i, bool turnOff = true)
+    {
+      if (i >= _count) return;
+      _deactivate(i);
+      if (turnOff) _leds[i]->off();
+      else         _leds[i]->setRGB(_r[i], _g[i], _b[i]);
+    }
+
+    /** @brief True while LED @p i is blinking under group control. */
+    bool isBlinking(uint8_t i) const { return (i < _count) && (_flags[i] & FLAG_BLINK); }
+
+    // -----------------------------------------------------------------------
+    // Group-wide operations
+    // -----------------------------------------------------------------------
+
+    /** @brief Stop all blinking and turn every LED OFF. */
+    void allOff(void)
+    {
+      for (uint8_t i = 0; i < _count; ++i)
+      {
+        _flags[i] = 0;
+        _leds[i]->off();
+      }
+      _activeCount = 0;
+    }
+
+    /**
+     * @brief Apply one brightness to every LED.
+     * @param b Brightness scale (0 = off, 255 = full).
+     */
+    void setBrightness(uint8_t b)
+    {
+      _userBrightness = b;
+      _appliedBrightness = _limitedBrightness();
+      for (uint8_t i = 0; i < _count; ++i) _leds[i]->setBrightness(_appliedBrightness);
+    }
+
+    // -----------------------------------------------------------------------
+    // Power budget
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Supply current of one LED channel at full duty (default 20 mA each).
+     * @details Recomputes the running total once (O(N)); call at setup.
+     * @param mA_r Red   channel current in mA.
+     * @param mA_g Green channel current in mA.
+     * @param mA_b Blue  channel current in mA.
+     */
+    void setCurrentModel(uint16_t mA_r, uint16_t mA_g, uint16_t mA_b)
+    {
+      _mA[0] = mA_r; _mA[1] = mA_g; _mA[2] = mA_b;
+      _load = 0;
+      for (uint8_t i = 0; i < _count; ++i) _load += _ledLoad(i);
+      _applyLimit();
+    }
+
+    /**
+     * @brief Limit the estimated supply current of the group.
+     * @details The brightness of all members is lowered to
+     *          @c min(setBrightness value, 255 * budget / full-brightness current), so the
+     *          estimate stays within the budget; it rises again as colours get darker.
+     *          The estimate counts every member's colour, lit or not (worst case), and
+     *          assumes linear duty (gamma and white balance only lower the real current).
+     * @param mA Budget in mA (up to 16777215); 0 removes the limit.
+     */
+    void setPowerBudget(uint32_t mA)
+    {
+      _budget = (mA > 0xFFFFFFUL) ? 0xFFFFFFUL : mA;
+      _applyLimit();
+    }
+
+    /** @brief Estimated supply current in mA at the applied brightness (rounded up). */
+    uint32_t estimatedCurrent(void) const
+    {
+      return (_fullCurrent() * _appliedBrightness + 254) / 255;
+    }
+
+    /** @brief Brightness currently applied to the members (after the power limit). */
+    uint8_t appliedBrightness(void) const { return _appliedBrightness; }
+
+    /** @brief True while the power budget holds the brightness below the requested value. */
+    bool isPowerLimited(void) const { return _appliedBrightness < _userBrightness; }
+
+    /**
+     * @brief Start the same blink on every LED with a shared start time (phase-aligned).
+     * @param halfPeriod_ms Time for each ON or OFF interval (> 0).
+     * @param cycles        Number of ON/OFF cycles; 0 blinks forever.
+     */
+    void blinkAll(uint16_t halfPeriod_ms, uint16_t cycles)
+    {
+      if (halfPeriod_ms == 0) return;
+      const uint32_t now = millis();
+      for (uint8_t i = 0; i < _count; ++i) _startBlink(i, halfPeriod_ms, cycles, now);
+    }
+
+    /**
+     * @brief Advance all group-controlled blinks.
+     * @details Reads the clock once. Returns after one compare while no deadline is due;
+     *          otherwise visits only the blinking LEDs. Deadlines advance by whole
+     *          half-periods, so loop lateness does not accumulate; after a stall the missed
+     *          edges are consumed in one step and only the current phase is shown.
+     */
+    void update(void)
+    {
+      if (_activeCount == 0) return;
+      update((uint32_t)millis());
+    }
+
+    /**
+     * @brief Advance all group-controlled blinks using a caller-supplied clock.
+     * @param now Current time in milliseconds (same timebase as @c millis()).
+     */
+    void update(uint32_t now)
+    {
+      if (_activeCount == 0) return;
+      if ((int32_t)(now - _nextDeadline) < 0) return;
+
+      uint32_t next = now + 0x7FFFFFFFUL;
+      uint8_t k = 0;
+      while (k < _activeCount)
+      {
+        const uint8_t i = _active[k];
+
+        if ((int32_t)(now - _deadline[i]) >= 0)
+        {
+          // Consume every missed edge in one step; only the final phase is shown.
+          const uint32_t edges = (uint32_t)(now - _deadline[i]) / _halfPeriod[i] + 1;
+          const bool wasOn = (_flags[i] & FLAG_PHASE_ON) != 0;
+
+          // Finite mode: each OFF edge closes a cycle (edges alternate, starting with OFF if lit).
+          if (_cyclesLeft[i])
+          {
+            const uint32_t closed = wasOn ? (edges + 1) / 2 : edges / 2;
+            if (closed >= _cyclesLeft[i])
+            {
+              _flags[i] = 0;
+              _leds[i]->off();
+              _active[k] = _active[--_activeCount];  // swap-remove, revisit slot k
+              continue;
+            }
+            _cyclesLeft[i] = (uint16_t)(_cyclesLeft[i] - closed);
+          }
+
+          _deadline[i] += edges * _halfPeriod[i];
+          if (edges & 1)
+          {
+            _flags[i] ^= FLAG_PHASE_ON;
+            if (wasOn) _leds[i]->off();
+            else       _leds[i]->setRGB(_r[i], _g[i], _b[i]);
+          }
+        }
+
+        if ((int32_t)(_deadline[i] - next) < 0) next = _deadline[i];
+        ++k;
+      }
+      _nextDeadline = next;
+    }
+
+    /**
+     * @brief Absolute time of the earliest pending blink edge in the group.
+     * @details May be slightly early after @ref stopBlink; the next @ref update corrects it.
+     * @param[out] deadline Time in @c millis() units; untouched when idle.
+     * @retval true  At least one LED is blinking.
+     * @retval false Idle.
+     */
+    bool nextDeadlineMs(uint32_t &deadline) const
+    {
+      if (_activeCount == 0) return false;
+      deadline = _nextDeadline;
+      return true;
+    }
+
+  private:
+
+    // -----------------------------------------------------------------------
+    // Internal state (structure-of-arrays)
+    // -----------------------------------------------------------------------
+
+    static constexpr uint8_t FLAG_BLINK    = 0x01; ///< LED is blinking under group control.
+    static constexpr uint8_t FLAG_PHASE_ON = 0x02; ///< Current blink phase is ON.
+
+    RGBLED*  _leds[N];            ///< Member LEDs.
+    uint8_t  _r[N], _g[N], _b[N]; ///< Colour shown in the ON phase.
+    uint32_t _deadline[N];        ///< Absolute time of the next edge.
+    uint16_t _halfPeriod[N];      ///< Blink half-period in ms.
+    uint16_t _cyclesLeft[N];      ///< Remaining cycles (0 = infinite).
+    uint8_t  _flags[N];           ///< FLAG_* bits.
+
+    uint8_t  _active[N];          ///< Indices of blinking LEDs (first _activeCount entries).
+    uint8_t  _activeCount = 0;    ///< Number of blinking LEDs.
+    uint8_t  _count = 0;          ///< Number of member LEDs.
+    uint32_t _nextDeadline = 0;   ///< Earliest deadline over all blinking LEDs.
+
+    uint32_t _load = 0;           ///< Sum over members of colour x channel current (mA*255 units).
+    uint32_t _budget = 0;         ///< Current budget in mA (0 = unlimited).
+    uint16_t _mA[3] = {20, 20, 20}; ///< Full-duty current per channel in mA.
+    uint8_t  _userBrightness = 255;    ///< Brightness requested with setBrightness().
+    uint8_t  _appliedBrightness = 255; ///< Brightness applied to the members.
+
+    // -----------------------------------------------------------------------
+    // Internal helpers
+    // -----------------------------------------------------------------------
+
+    void _startBlink(uint8_t i, uint16_t halfPeriod_ms, uint16_t cycles, uint32_t now)
+    {
+      if (!(_flags[i] & FLAG_BLINK)) _active[_activeCount++] = i;
+
+      _flags[i]      = FLAG_BLINK | FLAG_PHASE_ON;
+      _halfPeriod[i] = halfPeriod_ms;
+      _cyclesLeft[i] = cycles;
+      _deadline[i]   = now + halfPeriod_ms;
+
+      // New deadline may be earlier than the cached minimum.
+      if (_activeCount == 1 || (int32_t)(_deadline[i] - _nextDeadline) < 0) _nextDeadline = _deadline[i];
+
+      _leds[i]->setRGB(_r[i], _g[i], _b[i]);
+    }
+
+    /// Colour load of LED @p i: channel values weighted by their full-duty current.
+    uint32_t _ledLoad(uint8_t i) const
+    {
+      return (uint32_t)_r[i] * _mA[0] + (uint32_t)_g[i] * _mA[1] + (uint32_t)_b[i] * _mA[2];
+    }
+
+    /// Store a colour and update the running load by the difference (O(1)).
+    void _setCache(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+      _load -= _ledLoad(i);
+      _r[i] = r; _g[i] = g; _b[i] = b;
+      _load += _ledLoad(i);
+    }
+
+    /// Group current in mA at full brightness, rounded up.
+    uint32_t _fullCurrent(void) const { return (_load + 254) / 255; }
+
+    uint8_t _limitedBrightness(void) const
+    {
+      if (!_budget) return _userBrightness;
+      const uint32_t full = _fullCurrent();
+      if (full <= _budget) return _userBrightness;
+      const uint32_t cap = _budget * 255UL / full;  // current scales linearly with brightness
+      return (cap < _userBrightness) ? (uint8_t)cap : _userBrightness;
+    }
+
+    /// Push a new limited brightness to the members; O(N) only when it changes.
+    void _applyLimit(void)
+    {
+      const uint8_t b = _limitedBrightness();
+      if (b == _appliedBrightness) return;
+      _appliedBrightness = b;
+      for (uint8_t i = 0; i < _count; ++i) _leds[i]->setBrightness(b);
+    }
+
+    void _deactivate(uint8_t i)
+    {
+      if (!(_flags[i] & FLAG_BLINK)) return;
+      _flags[i] = 0;
+      for (uint8_t k = 0; k < _activeCount; ++k)
+      {
+        if (_active[k] == i) { _active[k] = _active[--_activeCount]; break; }
+      }
+      // _nextDeadline may now be early; update() recomputes it on the next pass.
+    }
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+/**
+ * @file RGBLED_CommandQueue.h
+ * @brief Lock-free single-producer/single-consumer queue of LED commands.
+ * @details
+ *  - Lets an interrupt handler or a second core request colour and blink changes without
+ *    touching the pins: the producer posts compact 8-byte commands, the context that owns
+ *    the LEDs applies them with @ref RGBLED_CommandQueue::drain right before @c update().
+ *  - Producers never block and never disable interrupts: a post is a slot copy plus one
+ *    release store of the head index. A full queue rejects the command and counts it.
+ *  - @ref RGBLED_CommandQueue::drain coalesces per LED: a colour command is skipped when a later
+ *    one for the same LED makes it irrelevant (RGB replaces RGB/ON/OFF, ON/OFF replaces
+ *    ON/OFF), as long as no blink, fade or brightness command for that LED lies in between.
+ *  - Indices use GCC @c __atomic builtins (acquire/release), which compile to plain loads and
+ *    stores on AVR and add the needed barriers on multi-core targets.
+ *
+ * @code
+ *   RGBLED led;
+ *   RGBLED_CommandQueue<16> queue;
+ *
+ *   void onButton() { queue.postRGB(0, 255, 0, 0); }   // ISR: producer
+ *
+ *   void loop() {
+ *     queue.drain(led);                                // owner: consumer
+ *     led.update();
+ *   }
+ * @endcode
+ *
+ * @note Exactly one producer context and one consumer context per queue. Use one queue per
+ *       producer if several ISRs or tasks post commands.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+// ###########################################################################
+// Enumerations & Structures
+// ###########################################################################
+
+/**
+ * @enum RGBLED_CommandOp
+ * @brief Operation carried by a @ref RGBLED_Command.
+ */
+enum RGBLED_CommandOp : uint8_t
+{
+  RGBLED_CMD_RGB        = 0,  /**< setRGB(rgb). */
+  RGBLED_CMD_ON         = 1,  /**< on(). */
+  RGBLED_CMD_OFF        = 2,  /**< off(). */
+  RGBLED_CMD_BLINK      = 3,  /**< Non-blocking blink(ms, count), same arguments as RGBLED::blink. */
+  RGBLED_CMD_STOP_BLINK = 4,  /**< stopBlink(). */
+  RGBLED_CMD_FADE       = 5,  /**< fadeTo(rgb, ms). */
+  RGBLED_CMD_BRIGHTNESS = 6   /**< setBrightness(rgb[0]). */
+};
+
+/**
+ * @struct RGBLED_Command
+ * @brief One queued request (8 bytes).
+ */
+struct RGBLED_Command
+{
+  uint8_t  op;     ///< @ref RGBLED_CommandOp.
+  uint8_t  led;    ///< Target LED index.
+  uint16_t ms;     ///< Fade duration; blink: total time, or half-period if count is 0.
+  union
+  {
+    uint8_t  rgb[4];  ///< Colour (R,G,B); brightness in rgb[0].
+    uint16_t count;   ///< Blink count.
+  };
+};
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_CommandQueue
+ * @brief SPSC ring buffer of @ref RGBLED_Command with coalescing drain.
+ * @tparam SIZE Capacity in commands (power of two, 2..128).
+ * @tparam LEDS Number of LEDs addressed by the commands (1..255).
+ */
+template <uint8_t SIZE, uint8_t LEDS = 1>
+class RGBLED_CommandQueue
+{
+    static_assert(SIZE >= 2 && SIZE <= 128 && (SIZE & (SIZE - 1)) == 0,
+                  "RGBLED_CommandQueue: SIZE must be a power of two in 2..128");
+    static_assert(LEDS > 0, "RGBLED_CommandQueue: LEDS must be at least 1");
+
+  public:
+
+    // -----------------------------------------------------------------------
+    // Producer side (ISR or other core)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Append a command.
+     * @retval true  Queued.
+     * @retval false Queue full or LED index out of range; counted in @ref dropped.
+     */
+    bool post(const RGBLED_Command& cmd)
+    {
+      const uint8_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+      const uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+      if ((uint8_t)(head - tail) >= SIZE || cmd.led >= LEDS)
+      {
+        __atomic_store_n(&_dropped, (uint8_t)(_dropped + 1), __ATOMIC_RELAXED);
+        return false;
+      }
+
+      _buf[head & (SIZE - 1)] = cmd;
+      __atomic_store_n(&_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);  // publish the slot
+      return true;
+    }
+
+    /** @brief Post @c setRGB(r, g, b) for LED @p led. */
+    bool postRGB(uint8_t led, uint8_t r, uint8_t g, uint8_t b)          { return post(_make(RGBLED_CMD_RGB, led, 0, r, g, b)); }
+
+    /** @brief Post @c on() for LED @p led. */
+    bool postOn(uint8_t led)                                            { return post(_make(RGBLED_CMD_ON, led, 0, 0, 0, 0)); }
+
+    /** @brief Post @c off() for LED @p led. */
+    bool postOff(uint8_t led)                                           { return post(_make(RGBLED_CMD_OFF, led, 0, 0, 0, 0)); }
+
+    /**
+     * @brief Post a non-blocking @c blink(ms, count) for LED @p led.
+     * @param ms    As in @ref RGBLED::blink: total sequence time if @p count > 0, otherwise the
+     *              half-period of an endless blink.
+     * @param count ON/OFF cycles; 0 = forever.
+     */
+    bool postBlink(uint8_t led, uint16_t ms, uint16_t count)
+    {
+      RGBLED_Command c = _make(RGBLED_CMD_BLINK, led, ms, 0, 0, 0);
+      c.count = count;
+      return post(c);
+    }
+
+    /** @brief Post @c stopBlink() for LED @p led. */
+    bool postStopBlink(uint8_t led)                                     { return post(_make(RGBLED_CMD_STOP_BLINK, led, 0, 0, 0, 0)); }
+
+    /** @brief Post @c fadeTo(r, g, b, ms) for LED @p led (@c setRGB without RGBLED_ENABLE_FADE). */
+    bool postFade(uint8_t led, uint8_t r, uint8_t g, uint8_t b, uint16_t ms) { return post(_make(RGBLED_CMD_FADE, led, ms, r, g, b)); }
+
+    /** @brief Post @c setBrightness(b) for LED @p led. */
+    bool postBrightness(uint8_t led, uint8_t b)                         { return post(_make(RGBLED_CMD_BRIGHTNESS, led, 0, b, 0, 0)); }
+
+    // -----------------------------------------------------------------------
+    // Consumer side (context that owns the LEDs)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Take the oldest command without coalescing.
+     * @retval true  @p out holds the command.
+     * @retval false Queue empty.
+     */
+    bool pop(RGBLED_Command& out)
+    {
+      const uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+      const uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+      if (head == tail) return false;
+
+      out = _buf[tail & (SIZE - 1)];
+      __atomic_store_n(&_tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);  // hand the slot back
+      return true;
+    }
+
+    /**
+     * @brief Apply all pending commands to @p leds, skipping superseded colour commands.
+     * @details Only commands present when the call starts are applied; later posts wait for
+     *          the next call. The slots are released in one store at the end.
+     * @param leds Array of @p LEDS LED pointers (index = @ref RGBLED_Command::led).
+     * @return Number of commands applied.
+     */
+    uint8_t drain(RGBLED* const* leds)
+    {
+      const uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+      const uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+      if (head == tail) return 0;
+
+      // Backward pass, one bit per LED: "a later RGB follows" and "a later ON/OFF follows".
+      // setRGB rewrites both the colour cache and the output; on/off only the output.
+      uint8_t laterRgb[(LEDS + 7) / 8] = {0};
+      uint8_t laterOnOff[(LEDS + 7) / 8] = {0};
+      for (uint8_t i = head; i != tail; )
+      {
+        RGBLED_Command& c = _buf[(uint8_t)(--i) & (SIZE - 1)];
+        const uint8_t byte = c.led >> 3, bit = (uint8_t)(1u << (c.led & 7));
+        if (c.op == RGBLED_CMD_RGB)
+        {
+          if (laterRgb[byte] & bit) c.op = OP_SKIP;
+          else                      laterRgb[byte] |= bit;
+        }
+        else if (c.op == RGBLED_CMD_ON || c.op == RGBLED_CMD_OFF)
+        {
+          if ((laterRgb[byte] | laterOnOff[byte]) & bit) c.op = OP_SKIP;
+          else                                           laterOnOff[byte] |= bit;
+        }
+        else
+        {
+          // Blink, fade and brightness depend on the state before them: barrier.
+          laterRgb[byte]   &= (uint8_t)~bit;
+          laterOnOff[byte] &= (uint8_t)~bit;
+        }
+      }
+
+      // Forward pass: apply in order.
+      uint8_t applied = 0;
+      for (uint8_t i = tail; i != head; ++i)
+      {
+        const RGBLED_Command& c = _buf[i & (SIZE - 1)];
+        if (c.op == OP_SKIP) { ++_coalesced; continue; }
+        _apply(*leds[c.led], c);
+        ++applied;
+      }
+
+      __atomic_store_n(&_tail, head, __ATOMIC_RELEASE);
+      return applied;
+    }
+
+    /** @brief Single-LED form of @ref drain (LED index 0). */
+    uint8_t drain(RGBLED& led)
+    {
+      static_assert(LEDS == 1, "RGBLED_CommandQueue: use drain(leds) when LEDS > 1");
+      RGBLED* const leds[1] = { &led };
+      return drain(leds);
+    }
+
+    /** @brief Number of commands waiting (approximate while the producer is active). */
+    uint8_t pending(void) const
+    {
+      return (uint8_t)(__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE));
+    }
+
+    // -----------------------------------------------------------------------
+    // Statistics
+    // -----------------------------------------------------------------------
+
+    /** @brief Commands rejected by @ref post (queue full or bad index); wraps at 255. */
+    uint8_t dropped(void) const { return __atomic_load_n(&_dropped, __ATOMIC_RELAXED); }
+
+    /** @brief Colour commands skipped by @ref drain because a newer one superseded them. */
+    uint32_t coalesced(void) const { return _coalesced; }
+
+  private:
+
+    static constexpr uint8_t OP_SKIP = 0xFF;  ///< Marks a coalesced slot during drain().
+
+    RGBLED_Command _buf[SIZE];   ///< Ring storage.
+    uint8_t  _head = 0;          ///< Next slot to write (producer-owned, free-running).
+    uint8_t  _tail = 0;          ///< Next slot to read (consumer-owned, free-running).
+    uint8_t  _dropped = 0;       ///< Producer-side reject counter.
+    uint32_t _coalesced = 0;     ///< Consumer-side coalesce counter.
+
+    static RGBLED_Command _make(uint8_t op, uint8_t led, uint16_t ms, uint8_t r, uint8_t g, uint8_t b)
+    {
+      RGBLED_Command c;
+      c.op = op; c.led = led; c.ms = ms;
+      c.rgb[0] = r; c.rgb[1] = g; c.rgb[2] = b; c.rgb[3] = 0;
+      return c;
+    }
+
+    static void _apply(RGBLED& led, const RGBLED_Command& c)
+    {
+      switch (c.op)
+      {
+        case RGBLED_CMD_RGB:        led.setRGB(c.rgb[0], c.rgb[1], c.rgb[2]); break;
+        case RGBLED_CMD_ON:         led.on(); break;
+        case RGBLED_CMD_OFF:        led.off(); break;
+        case RGBLED_CMD_BLINK:      led.blink(c.ms, c.count, false); break;
+        case RGBLED_CMD_STOP_BLINK: led.stopBlink(); break;
+#if RGBLED_ENABLE_FADE
+        case RGBLED_CMD_FADE:       led.fadeTo(c.rgb[0], c.rgb[1], c.rgb[2], c.ms); break;
+#else
+        case RGBLED_CMD_FADE:       led.setRGB(c.rgb[0], c.rgb[1], c.rgb[2]); break;  // no fades compiled in
+#endif
+        case RGBLED_CMD_BRIGHTNESS: led.setBrightness(c.rgb[0]); break;
+        default: break;
+      }
+    }
+};
@@ -0,0 +1,352 @@
+#pragma once
+
+/**
+ * @file RGBLED_Compositor.h
+ * @brief Layered colour compositor for one @ref RGBLED: base colour plus prioritized overlays.
+ * @details
+ *  - Each layer has a colour, an 8-bit alpha, a priority and an optional effect
+ *    (@ref RGBLED_EffectKind). Visible layers are blended bottom-up by priority with integer
+ *    math, and the result is written to the LED with one @c setRGB.
+ *  - Showing or hiding an overlay (notification, fault, identify) never touches the others,
+ *    so hiding it restores exactly what was below it, including a running effect.
+ *  - Recomposition runs only when a layer changed or an animated layer is visible; an idle
+ *    compositor costs one compare per @ref RGBLED_Compositor::update.
+ *  - Breathe, heartbeat and strobe modulate the layer's alpha, so the layers below show
+ *    through; rainbow replaces the layer's colour. Effects use the same phase math as
+ *    @ref RGBLED and are pure functions of the time since the layer was shown.
+ *
+ * @code
+ *   RGBLED led;
+ *   RGBLED_Compositor<3> layers(led);   // 0 = base, 1 = notification, 2 = fault
+ *
+ *   void setup() {
+ *     // ... configure, init() and enablePWM(true) ...
+ *     layers.setColor(0, 0, 0, 80);  layers.show(0);                // dim blue base
+ *     layers.setColor(1, 0, 255, 0); layers.setEffect(1, RGBLED_EFFECT_STROBE, 200, 128);
+ *   }
+ *   void onMessage() { layers.show(1, 3000); }                      // green flashes for 3 s
+ *   void loop() { layers.update(); led.update(); }
+ * @endcode
+ *
+ * @note The compositor owns the colour of its LED: do not run @ref RGBLED::blink, fades or
+ *       effects on the same LED. Brightness, gamma and dithering still apply.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_Compositor
+ * @brief Fixed set of @p LAYERS layers blended into one LED.
+ * @tparam LAYERS Number of layers (1..8). By default layer @c i has priority @c i, so higher
+ *                indices are drawn on top.
+ */
+template <uint8_t LAYERS>
+class RGBLED_Compositor
+{
+    static_assert(LAYERS > 0 && LAYERS <= 8, "RGBLED_Compositor: LAYERS must be in 1..8");
+
+  public:
+
+    /**
+     * @brief Bind the compositor to an LED. All layers start hidden, black and opaque.
+     * @param led LED object; must outlive the compositor.
+     */
+    explicit RGBLED_Compositor(RGBLED& led) : _led(&led)
+    {
+      for (uint8_t i = 0; i < LAYERS; ++i)
+      {
+        Layer& L = _layers[i];
+        L.t0 = L.rate = L.expires = 0;
+        L.r = L.g = L.b = 0;
+        L.alpha    = 255;
+        L.priority = i;
+        L.kind     = RGBLED_EFFECT_NONE;
+        L.param    = 0;
+        L.flags    = 0;
+        _order[i]  = i;
+      }
+    }
+
+    // -----------------------------------------------------------------------
+    // Layer setup
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Set the colour of a layer.
+     * @param layer Layer index (0..LAYERS-1).
+     * @param r     Red   intensity (0..255)
+     * @param g     Green intensity (0..255)
+     * @param b     Blue  intensity (0..255)
+     */
+    void setColor(uint8_t layer, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if (layer >= LAYERS) return;
+      Layer& L = _layers[layer];
+      L.r = r; L.g = g; L.b = b;
+      _touch(layer);
+    }
+
+    /**
+     * @brief Set the opacity of a layer.
+     * @param layer Layer index (0..LAYERS-1).
+     * @param alpha 0 = transparent, 255 = opaque (hides all lower layers).
+     */
+    void setAlpha(uint8_t layer, uint8_t alpha)
+    {
+      if (layer >= LAYERS) return;
+      _layers[layer].alpha = alpha;
+      _touch(layer);
+    }
+
+    /**
+     * @brief Set the drawing order of a layer; higher priorities are drawn on top.
+     * @details Equal priorities are drawn in index order. Re-sorts @p LAYERS entries; call it
+     *          at setup rather than per frame.
+     * @param layer    Layer index (0..LAYERS-1).
+     * @param priority Priority (0..255).
+     */
+    void setPriority(uint8_t layer, uint8_t priority)
+    {
+      if (layer >= LAYERS) return;
+      _layers[layer].priority = priority;
+
+      // Insertion sort by (priority, index): stable and tiny for up to 8 entries.
+      for (uint8_t k = 1; k < LAYERS; ++k)
+      {
+        const uint8_t idx = _order[k];
+        uint8_t j = k;
+        while (j > 0 && _before(idx, _order[j - 1])) { _order[j] = _order[j - 1]; --j; }
+        _order[j] = idx;
+      }
+      _touch(layer);
+    }
+
+    /**
+     * @brief Animate a layer with a procedural effect.
+     * @param layer     Layer index (0..LAYERS-1).
+     * @param kind      Effect; @ref RGBLED_EFFECT_NONE (or @p period_ms 0) shows the plain colour.
+     * @param period_ms Effect period in ms.
+     * @param param     Strobe ON fraction (1..255); ignored by the other effects.
+     * @note  Restarts the effect at phase 0.
+     */
+    void setEffect(uint8_t layer, RGBLED_EffectKind kind, uint16_t period_ms, uint8_t param = 32)
+    {
+      if (layer >= LAYERS) return;
+      Layer& L = _layers[layer];
+      L.kind  = period_ms ? (uint8_t)kind : (uint8_t)RGBLED_EFFECT_NONE;
+      L.param = param;
+      L.rate  = RGBLED_phaseRate(period_ms);  // one division per setup
+      L.t0    = millis();
+      _updateMasks(layer);
+      _touch(layer);
+    }
+
+    // -----------------------------------------------------------------------
+    // Visibility
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Make a layer visible and restart its effect.
+     * @param layer      Layer index (0..LAYERS-1).
+     * @param timeout_ms Hide automatically after this time; 0 keeps it until @ref hide.
+     */
+    void show(uint8_t layer, uint32_t timeout_ms = 0)
+    {
+      if (layer >= LAYERS) return;
+      Layer& L = _layers[layer];
+      L.t0 = millis();
+      L.flags |= FLAG_VISIBLE;
+      if (timeout_ms) { L.flags |= FLAG_TIMED; L.expires = L.t0 + timeout_ms; }
+      else            { L.flags &= (uint8_t)~FLAG_TIMED; }
+      _updateMasks(layer);
+      _dirty = true;
+    }
+
+    /** @brief Hide a layer; the layers below it show again on the next @ref update. */
+    void hide(uint8_t layer)
+    {
+      if (layer >= LAYERS) return;
+      _layers[layer].flags = 0;
+      _updateMasks(layer);
+      _dirty = true;
+    }
+
+    /** @brief True while layer @p layer is visible. */
+    bool isVisible(uint8_t layer) const
+    {
+      return (layer < LAYERS) && (_layers[layer].flags & FLAG_VISIBLE);
+    }
+
+    // -----------------------------------------------------------------------
+    // Composition
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Expire timed layers and recompose if needed.
+     * @details Returns after one compare while nothing is dirty, animated or timed.
+     */
+    void update(void)
+    {
+      if (!_dirty && !_animMask && !_timedMask) return;
+      update((uint32_t)millis());
+    }
+
+    /**
+     * @brief Expire timed layers and recompose if needed, using a caller-supplied clock.
+     * @param now Current time in milliseconds (same timebase as @c millis()).
+     */
+    void update(uint32_t now)
+    {
+      if (_timedMask)
+      {
+        for (uint8_t i = 0; i < LAYERS; ++i)
+        {
+          if ((_timedMask & (1u << i)) && (int32_t)(now - _layers[i].expires) >= 0) hide(i);
+        }
+      }
+      if (!_dirty && !_animMask) return;
+      _compose(now);
+    }
+
+    /**
+     * @brief Force the next @ref update to recompose and rewrite the LED (e.g. after the
+     *        LED was changed directly).
+     */
+    void refresh(void)
+    {
+      _dirty = true;
+      _outValid = false;
+    }
+
+    /**
+     * @brief Absolute time of the next change.
+     * @details A dirty or animated compositor is due now; otherwise the earliest layer timeout.
+     * @param[out] deadline Time in @c millis() units; untouched when idle.
+     * @retval true  Work is pending.
+     * @retval false Idle.
+     */
+    bool nextDeadlineMs(uint32_t &deadline) const
+    {
+      if (_dirty || _animMask) { deadline = millis(); return true; }
+      if (!_timedMask) return false;
+
+      bool any = false;
+      for (uint8_t i = 0; i < LAYERS; ++i)
+      {
+        if (!(_timedMask & (1u << i))) continue;
+        if (!any || (int32_t)(_layers[i].expires - deadline) < 0) deadline = _layers[i].expires;
+        any = true;
+      }
+      return any;
+    }
+
+    /** @brief Number of recompositions since construction (for measuring idle cost). */
+    uint32_t compositions(void) const { return _compositions; }
+
+  private:
+
+    static constexpr uint8_t FLAG_VISIBLE = 0x01; ///< Layer takes part in composition.
+    static constexpr uint8_t FLAG_TIMED   = 0x02; ///< Layer hides itself at @c expires.
+
+    struct Layer
+    {
+      uint32_t t0;        ///< Effect origin (time the layer was shown).
+      uint32_t rate;      ///< Effect phase rate (2^32 / period).
+      uint32_t expires;   ///< Auto-hide time (FLAG_TIMED).
+      uint8_t  r, g, b;   ///< Layer colour.
+      uint8_t  alpha;     ///< Opacity (255 = opaque).
+      uint8_t  priority;  ///< Drawing order (higher on top).
+      uint8_t  kind;      ///< RGBLED_EffectKind.
+      uint8_t  param;     ///< Effect parameter (strobe duty).
+      uint8_t  flags;     ///< FLAG_* bits.
+    };
+
+    RGBLED*  _led;                  ///< Output LED.
+    Layer    _layers[LAYERS];       ///< Layer state (index = layer id).
+    uint8_t  _order[LAYERS];        ///< Layer ids sorted bottom to top.
+    uint8_t  _animMask = 0;         ///< Bit i: layer i visible with an effect.
+    uint8_t  _timedMask = 0;        ///< Bit i: layer i visible with a timeout.
+    uint8_t  _out[3] = {0, 0, 0};   ///< Last colour written to the LED.
+    bool     _outValid = false;     ///< True once _out matches the LED.
+    bool     _dirty = false;        ///< A layer changed since the last composition.
+    uint32_t _compositions = 0;     ///< Composition counter.
+
+    bool _before(uint8_t a, uint8_t b) const
+    {
+      return (_layers[a].priority < _layers[b].priority) ||
+             (_layers[a].priority == _layers[b].priority && a < b);
+    }
+
+    /// A visible layer changed: recompose. Hidden layers change nothing on screen.
+    void _touch(uint8_t layer)
+    {
+      if (_layers[layer].flags & FLAG_VISIBLE) _dirty = true;
+    }
+
+    void _updateMasks(uint8_t layer)
+    {
+      const Layer& L = _layers[layer];
+      const uint8_t bit = (uint8_t)(1u << layer);
+      const bool visible = (L.flags & FLAG_VISIBLE) != 0;
+      if (visible && L.kind)                 _animMask |= bit;  else _animMask &= (uint8_t)~bit;
+      if (visible && (L.flags & FLAG_TIMED)) _timedMask |= bit; else _timedMask &= (uint8_t)~bit;
+    }
+
+    void _compose(uint32_t now)
+    {
+      _dirty = false;
+      ++_compositions;
+
+      // The topmost opaque, static layer hides everything below it: start blending there.
+      uint8_t start = 0;
+      for (uint8_t k = LAYERS; k-- > 0; )
+      {
+        const Layer& L = _layers[_order[k]];
+        if ((L.flags & FLAG_VISIBLE) && L.alpha == 255 && L.kind == RGBLED_EFFECT_NONE) { start = k; break; }
+      }
+
+      uint8_t r = 0, g = 0, b = 0;
+      for (uint8_t k = start; k < LAYERS; ++k)
+      {
+        const Layer& L = _layers[_order[k]];
+        if (!(L.flags & FLAG_VISIBLE)) continue;
+
+        uint8_t lr = L.r, lg = L.g, lb = L.b, a = L.alpha;
+        if (L.kind)
+        {
+          const uint8_t phase = RGBLED_phase8(now - L.t0, L.rate);
+          switch (L.kind)
+          {
+            case RGBLED_EFFECT_RAINBOW:   RGBLED_hsvToRgb(phase, 255, 255, lr, lg, lb);   break;
+            case RGBLED_EFFECT_BREATHE:   a = RGBLED_scale8(a, RGBLED_breathe8(phase));   break;
+            case RGBLED_EFFECT_HEARTBEAT: a = RGBLED_scale8(a, RGBLED_heartbeat8(phase)); break;
+            default:                      a = RGBLED_scale8(a, RGBLED_strobe8(phase, L.param)); break;
+          }
+        }
+
+        // out = out * (1 - a) + layer * a; each term is floored, so the sum stays <= 255.
+        if (a == 255)  { r = lr; g = lg; b = lb; }
+        else if (a)
+        {
+          const uint8_t ia = (uint8_t)(255 - a);
+          r = (uint8_t)(RGBLED_scale8(r, ia) + RGBLED_scale8(lr, a));
+          g = (uint8_t)(RGBLED_scale8(g, ia) + RGBLED_scale8(lg, a));
+          b = (uint8_t)(RGBLED_scale8(b, ia) + RGBLED_scale8(lb, a));
+        }
+      }
+
+      if (_outValid && r == _out[0] && g == _out[1] && b == _out[2]) return;
+      _out[0] = r; _out[1] = g; _out[2] = b;
+      _outValid = true;
+      _led->setRGB(r, g, b);
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+/**
+ * @file RGBLED_Driver.h
+ * @brief Output-driver policies for the PWM path of @ref RGBLED and @ref RGBLED_Fixed.
+ * @details
+ *  A driver is any class with these three members (no base class, no virtual calls):
+ *  - @c void begin(uint8_t r, uint8_t g, uint8_t b) : bind the three channels. Called from
+ *    @c init() after the pins have been configured and preloaded OFF.
+ *  - @c void write3(uint8_t r, uint8_t g, uint8_t b, uint8_t dirty) : output three duties
+ *    (pin level, already inverted for active-low wiring). Bit 0/1/2 of @p dirty marks the
+ *    R/G/B values that changed; a driver may still write all three in one transaction.
+ *  - @c void release(void) : stop generating PWM on the channels. Called when PWM mode is
+ *    left, before the library takes the pins back with digital writes.
+ *
+ *  The driver is selected at compile time: as the @c DRIVER template parameter of
+ *  @ref RGBLED_Fixed, and through @ref RGBLED_PWM_DRIVER for @ref RGBLED. Calls are resolved
+ *  statically, so a small driver is inlined into the output path.
+ *
+ * @code
+ *   // Recording driver, e.g. to check the output sequence of a sketch.
+ *   struct LogDriver {
+ *     void begin(uint8_t, uint8_t, uint8_t) {}
+ *     void write3(uint8_t r, uint8_t g, uint8_t b, uint8_t) { Serial.println(r + g + b); }
+ *     void release(void) {}
+ *   };
+ *   RGBLED_Fixed<9, 10, 11, RGBLED_ACTIVE_HIGH, LogDriver> led;
+ * @endcode
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <Arduino.h>
+
+// ###########################################################################
+// Driver Definitions
+// ###########################################################################
+
+/**
+ * @class RGBLED_AnalogWriteDriver
+ * @brief Default driver: one @c analogWrite per changed channel on the MCU pins.
+ * @details If the legacy macro @c RGBLED_ANALOG_WRITE(pin, val) is defined, it is used instead
+ *          of @c analogWrite, so existing sketches keep their backend.
+ */
+class RGBLED_AnalogWriteDriver
+{
+  public:
+
+    /** @brief Remember the three pin numbers. */
+    void begin(uint8_t r, uint8_t g, uint8_t b)
+    {
+      _pin[0] = r; _pin[1] = g; _pin[2] = b;
+    }
+
+    /** @brief Write the changed duties. */
+    void write3(uint8_t r, uint8_t g, uint8_t b, uint8_t dirty)
+    {
+      if (dirty & 0x01) _write(_pin[0], r);
+      if (dirty & 0x02) _write(_pin[1], g);
+      if (dirty & 0x04) _write(_pin[2], b);
+    }
+
+    /** @brief Nothing to do: the library's next @c digitalWrite detaches the PWM timer. */
+    void release(void) {}
+
+  private:
+
+    uint8_t _pin[3] = {0, 0, 0}; ///< R, G, B pin numbers.
+
+    static void _write(uint8_t pin, uint8_t val)
+    {
+#ifdef RGBLED_ANALOG_WRITE
+      RGBLED_ANALOG_WRITE(pin, val);
+#else
+      analogWrite(pin, val);
+#endif
+    }
+};
+
+/**
+ * @class RGBLED_ChainSlotDriver
+ * @brief Driver that writes the three duties into one LED slot of a multi-LED frame buffer,
+ *        e.g. an @ref RGBLED_ShiftChain.
+ * @details
+ *  - Bind it with @c led.driver().attach(chain, slot) after @c init(). Any class with
+ *    @c setRGB(uint16_t led, uint8_t r, uint8_t g, uint8_t b) works as the chain.
+ *  - The chain type is erased behind one function pointer, so a single driver type serves
+ *    every chain and every slot; that is what @ref RGBLED_PWM_DRIVER needs, since it applies
+ *    to all @ref RGBLED instances.
+ *  - Only the PWM path reaches the driver: call @c enablePWM(true). The LED's pins are still
+ *    configured by @c init() and used by the digital path, so give it spare pins.
+ *  - Keep the LED @ref RGBLED_ACTIVE_HIGH and set the wiring on the chain instead; otherwise
+ *    the duties are inverted twice.
+ *  - @c release() switches the slot OFF, so leaving PWM mode does not freeze the colour.
+ *
+ * @code
+ *   RGBLED_ShiftChain<16, RGBLED_ShiftSPI<10>, 6> chain;
+ *   RGBLED_Fixed<2, 3, 4, RGBLED_ACTIVE_HIGH, RGBLED_ChainSlotDriver> led;  // spare pins
+ *
+ *   void setup() { chain.begin(); led.init(); led.driver().attach(chain, 5); led.enablePWM(true); }
+ * @endcode
+ */
+class RGBLED_ChainSlotDriver
+{
+  public:
+
+    /**
+     * @brief Route the duties to LED @p slot of @p chain.
+     * @details Sends the current duties so the slot shows the LED state right away.
+     */
+    template <class CHAIN>
+    void attach(CHAIN& chain, uint16_t slot)
+    {
+      _chain = &chain;
+      _set   = &_setRGB<CHAIN>;
+      _slot  = slot;
+      _set(_chain, _slot, _duty[0], _duty[1], _duty[2]);
+    }
+
+    /** @brief Slot written by this driver. */
+    uint16_t slot(void) const { return _slot; }
+
+    /** @brief Pins are not used; the slot starts OFF. */
+    void begin(uint8_t, uint8_t, uint8_t)
+    {
+      _duty[0] = _duty[1] = _duty[2] = 0;
+      if (_chain) _set(_chain, _slot, 0, 0, 0);
+    }
+
+    /** @brief Store the three duties in the slot (the chain skips unchanged bits). */
+    void write3(uint8_t r, uint8_t g, uint8_t b, uint8_t)
+    {
+      _duty[0] = r; _duty[1] = g; _duty[2] = b;
+      if (_chain) _set(_chain, _slot, r, g, b);
+    }
+
+    /** @brief Switch the slot OFF. */
+    void release(void) { write3(0, 0, 0, 0x07); }
+
+  private:
+
+    typedef void (*SetFn)(void* chain, uint16_t slot, uint8_t r, uint8_t g, uint8_t b);
+
+    void*    _chain = nullptr;   ///< Bound chain, or nullptr before attach().
+    SetFn    _set   = nullptr;   ///< setRGB of the bound chain type.
+    uint16_t _slot  = 0;         ///< LED index in the chain.
+    uint8_t  _duty[3] = {0, 0, 0}; ///< Last duties, replayed by attach().
+
+    template <class CHAIN>
+    static void _setRGB(void* chain, uint16_t slot, uint8_t r, uint8_t g, uint8_t b)
+    {
+      static_cast<CHAIN*>(chain)->setRGB(slot, r, g, b);
+    }
+};
+
+/**
+ * @def RGBLED_PWM_DRIVER
+ * @brief Driver type used by the PWM path of @ref RGBLED.
+ * @details RGBLED.cpp is a separate translation unit, so define it as a build flag together
+ *          with a header that declares the type, e.g.
+ *          @c -DRGBLED_PWM_DRIVER=MyDriver @c -include @c MyDriver.h.
+ *          @ref RGBLED_Fixed takes its driver as a template parameter instead.
+ */
+#ifndef RGBLED_PWM_DRIVER
+  #define RGBLED_PWM_DRIVER RGBLED_AnalogWriteDriver
+#endif
@@ -0,0 +1,138 @@
+
+// #################################################################################
+// Include libraries:
+
+#include "RGBLED_Effects.h"
+#include "RGBLED.h"
+
+// ##################################################################################
+// Tables:
+
+// round(127 * sin(pi/2 * i/64)), i = 0..64
+static const uint8_t RGBLED_SIN_Q[65] PROGMEM = {
+    0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,  40,  43,  46,
+   49,  51,  54,  57,  60,  63,  65,  68,  71,  73,  76,  78,  81,  83,  85,  88,
+   90,  92,  94,  96,  98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+  117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+  127
+};
+
+// Two Gaussian pulses (255 at 4, 190 at 14), one entry per 4 phase steps.
+static const uint8_t RGBLED_HEARTBEAT[64] PROGMEM = {
+    0,   8,  53, 173, 255, 173,  53,   8,   1,   0,   3,  20,  70, 148, 190, 148,
+   70,  20,   3,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+
+// Black-body RGB, one row per 128 K from 1000 K (Tanner Helland fit, rounded).
+static const uint8_t RGBLED_KELVIN[87][3] PROGMEM = {
+  {255, 68,  0}, {255, 80,  0}, {255, 91,  0}, {255,100,  0},   //  1000 K
+  {255,109,  0}, {255,117,  0}, {255,125,  0}, {255,132,  0},   //  1512 K
+  {255,138, 17}, {255,144, 34}, {255,150, 48}, {255,155, 61},   //  2024 K
+  {255,160, 73}, {255,165, 84}, {255,170, 95}, {255,175,104},   //  2536 K
+  {255,179,113}, {255,183,122}, {255,187,130}, {255,191,137},   //  3048 K
+  {255,194,144}, {255,198,151}, {255,201,157}, {255,204,163},   //  3560 K
+  {255,208,169}, {255,211,175}, {255,214,180}, {255,217,186},   //  4072 K
+  {255,219,191}, {255,222,196}, {255,225,200}, {255,227,205},   //  4584 K
+  {255,230,209}, {255,232,213}, {255,235,218}, {255,237,222},   //  5096 K
+  {255,239,226}, {255,242,229}, {255,244,233}, {255,246,237},   //  5608 K
+  {255,248,240}, {255,250,244}, {255,252,247}, {255,254,250},   //  6120 K
+  {255,251,255}, {252,247,255}, {246,244,255}, {242,242,255},   //  6632 K
+  {238,240,255}, {235,238,255}, {232,236,255}, {229,235,255},   //  7144 K
+  {227,233,255}, {225,232,255}, {223,231,255}, {221,229,255},   //  7656 K
+  {219,228,255}, {217,227,255}, {216,226,255}, {214,226,255},   //  8168 K
+  {213,225,255}, {211,224,255}, {210,223,255}, {209,223,255},   //  8680 K
+  {208,222,255}, {207,221,255}, {206,221,255}, {205,220,255},   //  9192 K
+  {204,219,255}, {203,219,255}, {202,218,255}, {201,218,255},   //  9704 K
+  {200,217,255}, {199,217,255}, {199,216,255}, {198,216,255},   // 10216 K
+  {197,215,255}, {197,215,255}, {196,214,255}, {195,214,255},   // 10728 K
+  {195,214,255}, {194,213,255}, {193,213,255}, {193,213,255},   // 11240 K
+  {192,212,255}, {192,212,255}, {191,211,255}    // 11752 K
+};
+
+// ##################################################################################
+// Waveforms:
+
+uint8_t RGBLED_sin8(uint8_t phase)
+{
+  const uint8_t i = phase & 0x3F;
+  const uint8_t q = pgm_read_byte(&RGBLED_SIN_Q[(phase & 0x40) ? (uint8_t)(64 - i) : i]);
+  return (phase & 0x80) ? (uint8_t)(128 - q) : (uint8_t)(128 + q);
+}
+
+uint8_t RGBLED_breathe8(uint8_t phase)
+{
+  // Shift by a quarter turn so the curve starts at its minimum (sin8 = 1).
+  uint8_t s = (uint8_t)(RGBLED_sin8((uint8_t)(phase - 64)) - 1);  // 0..254
+  s = (uint8_t)(s + (s >> 7));                                      // 0..255
+  return RGBLED_scale8(s, s);
+}
+
+uint8_t RGBLED_heartbeat8(uint8_t phase)
+{
+  // Linear interpolation between table entries.
+  const uint8_t i = phase >> 2;
+  const uint8_t a = pgm_read_byte(&RGBLED_HEARTBEAT[i]);
+  const uint8_t b = pgm_read_byte(&RGBLED_HEARTBEAT[(i + 1) & 0x3F]);
+  return (uint8_t)(a + (((int16_t)b - a) * (phase & 3) >> 2));
+}
+
+// ##################################################################################
+// Colour:
+
+// One sixth of the colour wheel: sector 0..5, f = position inside the sector (0..255).
+static void RGBLED_hsvSector(uint8_t sector, uint8_t f, uint8_t s, uint8_t v,
+                             uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  const uint8_t p = RGBLED_scale8(v, (uint8_t)(255 - s));
+  const uint8_t q = RGBLED_scale8(v, (uint8_t)(255 - RGBLED_scale8(s, f)));
+  const uint8_t t = RGBLED_scale8(v, (uint8_t)(255 - RGBLED_scale8(s, (uint8_t)(255 - f))));
+
+  switch (sector)
+  {
+    case 0:  r = v; g = t; b = p; break;
+    case 1:  r = q; g = v; b = p; break;
+    case 2:  r = p; g = v; b = t; break;
+    case 3:  r = p; g = q; b = v; break;
+    case 4:  r = t; g = p; b = v; break;
+    default: r = v; g = p; b = q; break;
+  }
+}
+
+void RGBLED_hsvToRgb(uint8_t h, uint8_t s, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  if (s == 0) { r = g = b = v; return; }
+
+  const uint16_t h6 = (uint16_t)h * 6;   // 0..1530
+  RGBLED_hsvSector((uint8_t)(h6 >> 8), (uint8_t)h6, s, v, r, g, b);
+}
+
+void RGBLED_hsv16ToRgb(uint16_t h, uint8_t s, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  if (s == 0) { r = g = b = v; return; }
+
+  // h * 6 / 256 without a 32-bit multiply: high and low byte separately.
+  const uint16_t h6 = (uint16_t)((h >> 8) * 6) + (uint16_t)(((h & 0xFF) * 6) >> 8);  // 0..1535
+  RGBLED_hsvSector((uint8_t)(h6 >> 8), (uint8_t)h6, s, v, r, g, b);
+}
+
+void RGBLED_kelvinToRgb(uint16_t kelvin, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+  if (kelvin < RGBLED_KELVIN_MIN) kelvin = RGBLED_KELVIN_MIN;
+  if (kelvin > RGBLED_KELVIN_MAX) kelvin = RGBLED_KELVIN_MAX;
+
+  const uint16_t k = (uint16_t)(kelvin - RGBLED_KELVIN_MIN);
+  const uint8_t  i = (uint8_t)(k >> 7);                 // row
+  const uint8_t  f = (uint8_t)((k & 0x7F) << 1);        // 0..254 towards the next row
+  const uint8_t  j = (i < 86) ? (uint8_t)(i + 1) : i;
+
+  uint8_t out[3];
+  for (uint8_t c = 0; c < 3; ++c)
+  {
+    const int16_t a = pgm_read_byte(&RGBLED_KELVIN[i][c]);
+    const int16_t d = (int16_t)pgm_read_byte(&RGBLED_KELVIN[j][c]) - a;
+    out[c] = (uint8_t)(a + ((d * f) >> 8));
+  }
+  r = out[0]; g = out[1]; b = out[2];
+}
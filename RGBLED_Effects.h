@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * @file RGBLED_Effects.h
+ * @brief Integer waveform and colour helpers (effects, HSV, colour temperature) for @ref RGBLED.
+ * @details
+ *  - Every effect is a pure function of an 8-bit phase, so a frame costs O(1) and can be
+ *    evaluated for any time: seeking is just a different phase, and LEDs sharing an origin
+ *    and period stay in sync without per-step state.
+ *  - The phase of a period is @c (elapsed * rate) >> 24 with @c rate = 2^32 / period, so the
+ *    per-frame cost is one 32-bit multiply; the division happens once per effect start.
+ *  - Waveforms use PROGMEM tables (quarter-wave sine, heartbeat envelope); no floats.
+ *  - Colour conversions (HSV, Kelvin) are integer-only: a few 8x8 multiplies, no divisions.
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <Arduino.h>
+
+// ###########################################################################
+// Enumerations
+// ###########################################################################
+
+/**
+ * @enum RGBLED_EffectKind
+ * @brief Procedural effect run by @ref RGBLED::update.
+ */
+enum RGBLED_EffectKind : uint8_t
+{
+  RGBLED_EFFECT_NONE      = 0,  /**< No effect running. */
+  RGBLED_EFFECT_BREATHE   = 1,  /**< Smooth rise and fall of the current colour. */
+  RGBLED_EFFECT_HEARTBEAT = 2,  /**< Double pulse ("lub-dub") of the current colour, then rest. */
+  RGBLED_EFFECT_STROBE    = 3,  /**< Current colour ON for a duty fraction of each period. */
+  RGBLED_EFFECT_RAINBOW   = 4   /**< Full-saturation hue cycle. */
+};
+
+// ###########################################################################
+// Phase helpers
+// ###########################################################################
+
+/**
+ * @brief Phase increment per millisecond for a period: @c 2^32 / period_ms, rounded up.
+ * @param period_ms Period in ms (> 1; 0 and 1 give a constant phase).
+ */
+static inline uint32_t RGBLED_phaseRate(uint16_t period_ms)
+{
+  return (period_ms > 1) ? 0xFFFFFFFFUL / period_ms + 1 : 0;
+}
+
+/**
+ * @brief 8-bit phase (0..255) after @p elapsed_ms at @p rate.
+ * @param elapsed_ms Time since the effect origin (wraps correctly).
+ * @param rate       Value returned by @ref RGBLED_phaseRate.
+ */
+static inline uint8_t RGBLED_phase8(uint32_t elapsed_ms, uint32_t rate)
+{
+  return (uint8_t)((elapsed_ms * rate) >> 24);
+}
+
+// ###########################################################################
+// Waveforms (phase 0..255 -> level 0..255)
+// ###########################################################################
+
+/** @brief Sine: @c 128 + 127*sin(2*pi*phase/256), from a 65-entry quarter-wave table. */
+uint8_t RGBLED_sin8(uint8_t phase);
+
+/** @brief Triangle: 0 at phase 0, 254 at phase 127/128, back towards 0. */
+static inline uint8_t RGBLED_tri8(uint8_t phase)
+{
+  return (uint8_t)((phase & 0x80) ? (uint8_t)(255 - phase) << 1 : phase << 1);
+}
+
+/** @brief Breathing curve: squared sine, 0 at phase 0 and 255 at phase 128 (eased ends). */
+uint8_t RGBLED_breathe8(uint8_t phase);
+
+/** @brief Heartbeat envelope: two pulses in the first ~quarter of the period, then dark. */
+uint8_t RGBLED_heartbeat8(uint8_t phase);
+
+/** @brief Square wave: 255 while @p phase < @p duty, else 0. */
+static inline uint8_t RGBLED_strobe8(uint8_t phase, uint8_t duty)
+{
+  return (phase < duty) ? 255 : 0;
+}
+
+// ###########################################################################
+// Colour
+// ###########################################################################
+
+/**
+ * @brief Integer HSV to RGB (six sectors, no floats).
+ * @param h Hue (0..255 = one full turn; 0 red, 85 green, 170 blue).
+ * @param s Saturation (0 = grey, 255 = pure).
+ * @param v Value (0..255).
+ * @param[out] r,g,b Resulting colour.
+ */
+void RGBLED_hsvToRgb(uint8_t h, uint8_t s, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b);
+
+/**
+ * @brief Integer HSV to RGB with a 16-bit hue, for smooth slow sweeps.
+ * @param h Hue (0..65535 = one full turn); resolves 1536 distinct hues instead of 256.
+ * @param s Saturation (0 = grey, 255 = pure).
+ * @param v Value (0..255).
+ * @param[out] r,g,b Resulting colour.
+ */
+void RGBLED_hsv16ToRgb(uint16_t h, uint8_t s, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b);
+
+/// Lowest colour temperature covered by @ref RGBLED_kelvinToRgb.
+static const uint16_t RGBLED_KELVIN_MIN = 1000;
+/// Highest colour temperature covered by @ref RGBLED_kelvinToRgb.
+static const uint16_t RGBLED_KELVIN_MAX = 12008;
+
+/**
+ * @brief Black-body colour of a temperature (RGB white point, full scale).
+ * @details Linear interpolation in a PROGMEM table sampled every 128 K; within 4 counts of
+ *          the usual curve fit (Tanner Helland) over the whole range.
+ * @param kelvin Temperature, clamped to @ref RGBLED_KELVIN_MIN .. @ref RGBLED_KELVIN_MAX.
+ * @param[out] r,g,b Resulting colour.
+ */
+void RGBLED_kelvinToRgb(uint16_t kelvin, uint8_t &r, uint8_t &g, uint8_t &b);
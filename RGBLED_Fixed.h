@@ -0,0 +1,477 @@
+#pragma once
+
+/**
+ * @file RGBLED_Fixed.h
+ * @brief Compile-time specialized RGB LED driver (pins and wiring fixed at build time).
+ * @details
+ *  - Core control API of @ref RGBLED: colors (boolean, RGB, HSV, Kelvin), on/off, PWM,
+ *    brightness, blinking and the tickless @c update(now) / @c nextDeadlineMs pair.
+ *  - Not carried over: fades, patterns, effects, colour tables (gamma, white balance),
+ *    soft PWM, dithering, statistics and tracing. Use @ref RGBLED for those.
+ *  - Pins and @ref RGBLED_ActiveMode are template parameters, validated with @c static_assert.
+ *  - No runtime parameter bag, no init guard, and the active-mode inversion is a
+ *    compile-time constant, so the compiler folds it out of every output path.
+ *  - On ATmega328P/168-class boards the port register and bit mask of each pin are also
+ *    folded at compile time (@ref RGBLED_FIXED_STATIC_PORTS); other AVR cores resolve them
+ *    once in @c init().
+ *  - PWM duties go through the @p DRIVER policy (see RGBLED_Driver.h), called statically.
+ *
+ * @code
+ *   RGBLED_Fixed<9, 10, 11, RGBLED_ACTIVE_LOW> led;
+ *
+ *   void setup() { led.init(); led.blue(); led.blink(1000, 0, false); }
+ *   void loop()  { led.blinkUpdate(); }
+ * @endcode
+ *
+ * @note Unlike @ref RGBLED, control calls made before @ref RGBLED_Fixed::init are not
+ *       ignored; call @c init() first.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+/**
+ * @def RGBLED_FIXED_STATIC_PORTS
+ * @brief 1 if @ref RGBLED_Fixed folds pin to port/bit mapping at compile time.
+ * @details Enabled for the ATmega328P/168 family (Uno, Nano, Pro Mini): digital pins 0-7 are
+ *          PORTD, 8-13 PORTB and 14-19 PORTC. Each channel write is then a constant-address
+ *          read-modify-write (usually a single @c sbi/@c cbi) and no pointers are kept in RAM.
+ *          Other AVR cores resolve the pins once in @c init() through the core's tables.
+ */
+#ifndef RGBLED_FIXED_STATIC_PORTS
+  #if RGBLED_FAST_GPIO && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+                           defined(__AVR_ATmega168__)  || defined(__AVR_ATmega168P__) || \
+                           defined(__AVR_ATmega88P__)  || defined(__AVR_ATmega48P__))
+    #define RGBLED_FIXED_STATIC_PORTS 1
+  #else
+    #define RGBLED_FIXED_STATIC_PORTS 0
+  #endif
+#endif
+
+#if RGBLED_FIXED_STATIC_PORTS
+/// Compile-time port and bit of an ATmega328P/168 Arduino pin.
+template <int PIN>
+struct RGBLED_StaticPin
+{
+    static_assert(PIN >= 0 && PIN <= 19, "RGBLED_Fixed: pin is not a digital pin of this board");
+    static constexpr uint8_t PORT_ID = (PIN < 8) ? 0 : (PIN < 14) ? 1 : 2;                    ///< D, B, C.
+    static constexpr uint8_t MASK = (uint8_t)(1u << ((PIN < 8) ? PIN : (PIN < 14) ? PIN - 8 : PIN - 14));
+    static volatile uint8_t& out(void) { return (PORT_ID == 0) ? PORTD : (PORT_ID == 1) ? PORTB : PORTC; }
+};
+#endif
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_Fixed
+ * @brief RGB LED with pins and wiring mode given as template parameters.
+ * @tparam RED_PIN     Arduino pin for Red channel.
+ * @tparam GREEN_PIN   Arduino pin for Green channel.
+ * @tparam BLUE_PIN    Arduino pin for Blue channel.
+ * @tparam ACTIVE_MODE Wiring mode (@ref RGBLED_ACTIVE_HIGH or @ref RGBLED_ACTIVE_LOW).
+ * @tparam DRIVER      PWM output driver with @c begin/write3/release (see RGBLED_Driver.h).
+ */
+template <int RED_PIN, int GREEN_PIN, int BLUE_PIN, RGBLED_ActiveMode ACTIVE_MODE = RGBLED_ACTIVE_HIGH,
+          class DRIVER = RGBLED_AnalogWriteDriver>
+class RGBLED_Fixed
+{
+    static_assert(RED_PIN >= 0 && GREEN_PIN >= 0 && BLUE_PIN >= 0,
+                  "RGBLED_Fixed: pins must be non-negative");
+#ifdef NUM_DIGITAL_PINS
+    static_assert(RED_PIN < NUM_DIGITAL_PINS && GREEN_PIN < NUM_DIGITAL_PINS && BLUE_PIN < NUM_DIGITAL_PINS,
+                  "RGBLED_Fixed: pin number exceeds NUM_DIGITAL_PINS of this board");
+#endif
+    static_assert(RED_PIN != GREEN_PIN && RED_PIN != BLUE_PIN && GREEN_PIN != BLUE_PIN,
+                  "RGBLED_Fixed: the three channels need distinct pins");
+    static_assert(ACTIVE_MODE == RGBLED_ACTIVE_HIGH || ACTIVE_MODE == RGBLED_ACTIVE_LOW,
+                  "RGBLED_Fixed: invalid active mode");
+
+    static constexpr bool    ON_HIGH   = (ACTIVE_MODE == RGBLED_ACTIVE_HIGH); ///< Wiring, folded at compile time.
+    static constexpr uint8_t OFF_LEVEL = ON_HIGH ? LOW : HIGH;                ///< Pin level that turns a channel off.
+    static constexpr uint8_t OFF_DUTY  = ON_HIGH ? 0 : 255;                   ///< PWM duty that turns a channel off.
+
+  public:
+
+    // -----------------------------------------------------------------------
+    // Initialization
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Configure pins glitch-free and switch the LED OFF.
+     * @return Always true (invalid configurations do not compile).
+     */
+    bool init(void)
+    {
+      digitalWrite(RED_PIN,   OFF_LEVEL);
+      digitalWrite(GREEN_PIN, OFF_LEVEL);
+      digitalWrite(BLUE_PIN,  OFF_LEVEL);
+
+      pinMode(RED_PIN,   OUTPUT);
+      pinMode(GREEN_PIN, OUTPUT);
+      pinMode(BLUE_PIN,  OUTPUT);
+
+      _resolvePorts();
+      _driver.begin(RED_PIN, GREEN_PIN, BLUE_PIN);
+
+      _r8 = _g8 = _b8 = 0;
+      _isOn = false;
+      _blink.stop();
+      _lastValid = false;
+      off();
+      return true;
+    }
+
+    // -----------------------------------------------------------------------
+    // Basic control methods
+    // -----------------------------------------------------------------------
+
+    /** @brief Set LED to a custom color (boolean channels). @sa RGBLED::set */
+    void set(bool redState, bool greenState, bool blueState)
+    {
+      _r8 = redState   ? 255 : 0;
+      _g8 = greenState ? 255 : 0;
+      _b8 = blueState  ? 255 : 0;
+      _applyOutputs();
+      _isOn = true;
+    }
+
+    /** @brief Turn LED completely OFF. */
+    void off(void)
+    {
+      _isOn = false;
+      if (_pwmEnabled) _writeOutputs(OFF_DUTY, OFF_DUTY, OFF_DUTY);
+      else             _writeOutputs(OFF_LEVEL, OFF_LEVEL, OFF_LEVEL);
+    }
+
+    /** @brief Turn LED back ON using the last cached color. */
+    void on(void)
+    {
+      _applyOutputs();
+      _isOn = ((_r8 | _g8 | _b8) != 0);
+    }
+
+    /** @brief Toggle LED state between cached color and OFF. */
+    void toggle(void) { if (_isOn) off(); else on(); }
+
+    /** @brief Invert all channels (R,G,B) regardless of cached color. */
+    void inverse(void) { set(_r8 == 0, _g8 == 0, _b8 == 0); }
+
+    /** @brief Return the current ON/OFF state. */
+    bool isOn(void) const { return _isOn; }
+
+    /** @brief Get the cached desired color as booleans. */
+    void getColor(bool &r, bool &g, bool &b) const { r = (_r8 != 0); g = (_g8 != 0); b = (_b8 != 0); }
+
+    /** @brief Number of channel writes skipped because the pin already held the value. */
+    uint32_t elidedWrites(void) const { return _elidedWrites; }
+
+    /** @brief Reset the @ref elidedWrites counter to zero. */
+    void resetElidedWrites(void) { _elidedWrites = 0; }
+
+    // --------------------------------------------------------------------------
+    // PWM / 8-bit color (optional)
+    // --------------------------------------------------------------------------
+
+    /** @brief Set 8-bit color (0..255 per channel). @sa RGBLED::setRGB */
+    void setRGB(uint8_t r, uint8_t g, uint8_t b)
+    {
+      _r8 = r; _g8 = g; _b8 = b;
+      _applyOutputs();
+      _isOn = (_r8 | _g8 | _b8) != 0;
+    }
+
+    /** @brief Set color from hue, saturation and value. @sa RGBLED::setHSV */
+    void setHSV(uint8_t h, uint8_t s, uint8_t v)
+    {
+      uint8_t r, g, b;
+      RGBLED_hsvToRgb(h, s, v, r, g, b);
+      setRGB(r, g, b);
+    }
+
+    /** @brief Set a white of the given color temperature. @sa RGBLED::setKelvin */
+    void setKelvin(uint16_t kelvin, uint8_t v = 255)
+    {
+      uint8_t r, g, b;
+      RGBLED_kelvinToRgb(kelvin, r, g, b);
+      setRGB(RGBLED_scale8(r, v), RGBLED_scale8(g, v), RGBLED_scale8(b, v));
+    }
+
+    /** @brief Enable/disable PWM path. @sa RGBLED::enablePWM */
+    void enablePWM(bool en)
+    {
+      const bool leavingPwm = (_pwmEnabled && !en);
+      if (_pwmEnabled != en) _lastValid = false;
+      _pwmEnabled = en;
+
+      if (!leavingPwm) return;
+
+      _driver.release();
+
+      // Detach the PWM timers through digitalWrite before the direct path takes over; the
+      // direct path comes back only if it was set up (init() resolved the ports).
+#if RGBLED_FAST_GPIO
+      const bool fastGpio = _fastGpio;
+      _fastGpio = false;
+#endif
+      if (_isOn) _applyOutputs();
+      else       off();
+#if RGBLED_FAST_GPIO
+      _fastGpio = fastGpio;
+#endif
+    }
+
+    /** @brief Access the PWM output driver, e.g. to configure it. */
+    DRIVER& driver(void) { return _driver; }
+
+    /** @brief Global brightness (0..255), only affects PWM path. */
+    void setBrightness(uint8_t b)
+    {
+      _brightness = b;
+      if (_isOn) _applyOutputs();
+    }
+
+    // -----------------------------------------------------------------------
+    // Blink utilities
+    // -----------------------------------------------------------------------
+
+    /** @brief Blink the LED. Same semantics as @ref RGBLED::blink. */
+    void blink(uint16_t duration_ms, uint32_t number, bool blocking = true)
+    {
+      if (duration_ms == 0) { _blink.stop(); off(); return; }
+
+      if (number == 0)
+      {
+        _blink.startInfinite(duration_ms, millis());
+        on();
+        return;
+      }
+
+      _blink.prepare(duration_ms, number);
+
+      if (blocking)
+      {
+        const uint8_t r = _r8, g = _g8, b = _b8;
+        uint32_t deadline = millis();
+        for (uint32_t i = 0; i < number; ++i) {
+          set(r != 0, g != 0, b != 0);
+          deadline += _blink.nextDelay();
+          RGBLED_waitUntil(deadline, _waitHook);
+          off();
+          deadline += _blink.nextDelay();
+          RGBLED_waitUntil(deadline, _waitHook);
+        }
+      }
+      else
+      {
+        _blink.start(millis());
+        on();
+      }
+    }
+
+    /** @brief Install a cooperative wait callback for blocking blinks. @sa RGBLED::setWaitHook */
+    void setWaitHook(RGBLED_WaitHook hook) { _waitHook = hook; }
+
+    /** @brief Stop non-blocking blink immediately. */
+    void stopBlink(bool turnOff = true)
+    {
+      _blink.stop();
+      if (turnOff) off();
+      else _applyOutputs();
+    }
+
+    /** @brief Get blinking status (only meaningful in non-blocking mode). */
+    bool isBlinking(void) { return _blink.active(); }
+
+    /** @brief Progress blinking sequence in non-blocking mode. */
+    void blinkUpdate(void) { update(); }
+
+    /** @brief Service the non-blocking blink; reads the clock only while one runs. @sa RGBLED::update */
+    void update(void)
+    {
+      if (_blink.active()) update(millis());
+    }
+
+    /**
+     * @brief Service the non-blocking blink using a caller-supplied clock.
+     * @param now Current time in milliseconds (same timebase as @c millis()).
+     */
+    void update(uint32_t now)
+    {
+      if (!_blink.active()) return;
+
+      switch (_blink.poll(now))
+      {
+        case RGBLED_BlinkTimer::EVENT_EDGE: toggle(); break;
+        case RGBLED_BlinkTimer::EVENT_DONE: off();    break;
+        default: break;
+      }
+    }
+
+    /**
+     * @brief Absolute time of the next blink edge. @sa RGBLED::nextDeadlineMs
+     * @param[out] deadline Time in @c millis() units; untouched when idle.
+     * @return false if no blink is running (nothing to do until the next API call).
+     */
+    bool nextDeadlineMs(uint32_t &deadline) const
+    {
+      if (!_blink.active()) return false;
+      deadline = _blink.deadline();
+      return true;
+    }
+
+    // -----------------------------------------------------------------------
+    // Color presets
+    // -----------------------------------------------------------------------
+
+    void red(void)    { set(true,  false, false); } ///< Set LED to Red.
+    void green(void)  { set(false, true,  false); } ///< Set LED to Green.
+    void blue(void)   { set(false, false, true ); } ///< Set LED to Blue.
+    void yellow(void) { set(true,  true,  false); } ///< Set LED to Yellow (Red+Green).
+    void purple(void) { set(true,  false, true ); } ///< Set LED to Purple (Red+Blue).
+    void cyan(void)   { set(false, true,  true ); } ///< Set LED to Cyan (Green+Blue).
+    void white(void)  { set(true,  true,  true ); } ///< Set LED to White (Red+Green+Blue).
+
+  private:
+
+    // -----------------------------------------------------------------------
+    // Internal state
+    // -----------------------------------------------------------------------
+
+    bool    _isOn       = false;
+    bool    _pwmEnabled = false;
+    uint8_t _brightness = 255;
+    uint8_t _r8 = 0, _g8 = 0, _b8 = 0;
+
+    RGBLED_BlinkTimer _blink;
+    RGBLED_WaitHook _waitHook = nullptr;
+    DRIVER _driver;
+
+    bool     _lastValid = false;
+    uint8_t  _lastR = 0, _lastG = 0, _lastB = 0;
+    uint32_t _elidedWrites = 0;
+
+#if RGBLED_FAST_GPIO
+    bool _fastGpio = false;
+#endif
+#if RGBLED_FAST_GPIO && !RGBLED_FIXED_STATIC_PORTS
+    bool _samePort = false;
+    volatile uint8_t* _outR = nullptr;
+    volatile uint8_t* _outG = nullptr;
+    volatile uint8_t* _outB = nullptr;
+    uint8_t _maskR = 0, _maskG = 0, _maskB = 0;
+#endif
+
+    // -----------------------------------------------------------------------
+    // Internal helpers
+    // -----------------------------------------------------------------------
+
+    void _applyOutputs(void)
+    {
+      const uint8_t r = RGBLED_scale8(_r8, _brightness);
+      const uint8_t g = RGBLED_scale8(_g8, _brightness);
+      const uint8_t b = RGBLED_scale8(_b8, _brightness);
+
+      if (_pwmEnabled)
+      {
+        if (ON_HIGH) _writeOutputs(r, g, b);
+        else         _writeOutputs(255 - r, 255 - g, 255 - b);
+      }
+      else
+      {
+        const uint8_t on = ON_HIGH ? HIGH : LOW;
+        _writeOutputs(r ? on : OFF_LEVEL, g ? on : OFF_LEVEL, b ? on : OFF_LEVEL);
+      }
+    }
+
+    void _writeOutputs(uint8_t r, uint8_t g, uint8_t b)
+    {
+      uint8_t dirty = 0x07;
+      if (_lastValid)
+      {
+        dirty = (uint8_t)((r != _lastR ? 0x01 : 0) | (g != _lastG ? 0x02 : 0) | (b != _lastB ? 0x04 : 0));
+      }
+
+      _elidedWrites += (uint8_t)(3 - ((dirty & 1) + ((dirty >> 1) & 1) + ((dirty >> 2) & 1)));
+      if (!dirty) return;
+
+      _lastR = r; _lastG = g; _lastB = b;
+      _lastValid = true;
+
+      if (_pwmEnabled)
+      {
+        _driver.write3(r, g, b, dirty);
+        return;
+      }
+
+#if RGBLED_FIXED_STATIC_PORTS
+      if (_fastGpio)
+      {
+        typedef RGBLED_StaticPin<RED_PIN>   PR;
+        typedef RGBLED_StaticPin<GREEN_PIN> PG;
+        typedef RGBLED_StaticPin<BLUE_PIN>  PB;
+        constexpr bool samePort = (PR::PORT_ID == PG::PORT_ID) && (PR::PORT_ID == PB::PORT_ID);
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        if (samePort)
+        {
+          const uint8_t setBits = (r ? PR::MASK : 0) | (g ? PG::MASK : 0) | (b ? PB::MASK : 0);
+          PR::out() = (uint8_t)((PR::out() & ~(PR::MASK | PG::MASK | PB::MASK)) | setBits);
+        }
+        else
+        {
+          if (dirty & 0x01) { if (r) PR::out() |= PR::MASK; else PR::out() &= (uint8_t)~PR::MASK; }
+          if (dirty & 0x02) { if (g) PG::out() |= PG::MASK; else PG::out() &= (uint8_t)~PG::MASK; }
+          if (dirty & 0x04) { if (b) PB::out() |= PB::MASK; else PB::out() &= (uint8_t)~PB::MASK; }
+        }
+        SREG = oldSREG;
+        return;
+      }
+#elif RGBLED_FAST_GPIO
+      if (_fastGpio)
+      {
+        const uint8_t oldSREG = SREG;
+        cli();
+        if (_samePort)
+        {
+          const uint8_t setBits = (r ? _maskR : 0) | (g ? _maskG : 0) | (b ? _maskB : 0);
+          *_outR = (uint8_t)((*_outR & ~(_maskR | _maskG | _maskB)) | setBits);
+        }
+        else
+        {
+          if (dirty & 0x01) { if (r) *_outR |= _maskR; else *_outR &= (uint8_t)~_maskR; }
+          if (dirty & 0x02) { if (g) *_outG |= _maskG; else *_outG &= (uint8_t)~_maskG; }
+          if (dirty & 0x04) { if (b) *_outB |= _maskB; else *_outB &= (uint8_t)~_maskB; }
+        }
+        SREG = oldSREG;
+        return;
+      }
+#endif
+
+      if (dirty & 0x01) digitalWrite(RED_PIN,   r);
+      if (dirty & 0x02) digitalWrite(GREEN_PIN, g);
+      if (dirty & 0x04) digitalWrite(BLUE_PIN,  b);
+    }
+
+    void _resolvePorts(void)
+    {
+#if RGBLED_FIXED_STATIC_PORTS
+      _fastGpio = true;
+#elif RGBLED_FAST_GPIO
+      _outR  = portOutputRegister(digitalPinToPort(RED_PIN));
+      _outG  = portOutputRegister(digitalPinToPort(GREEN_PIN));
+      _outB  = portOutputRegister(digitalPinToPort(BLUE_PIN));
+      _maskR = digitalPinToBitMask(RED_PIN);
+      _maskG = digitalPinToBitMask(GREEN_PIN);
+      _maskB = digitalPinToBitMask(BLUE_PIN);
+      _samePort = (_outR == _outG) && (_outR == _outB);
+      _fastGpio = true;
+#endif
+    }
+};
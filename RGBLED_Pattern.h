@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file RGBLED_Pattern.h
+ * @brief Compact byte-coded light patterns for @ref RGBLED::playPattern.
+ * @details
+ *  - A pattern is a @c uint8_t array (normally in PROGMEM) of instructions built with the
+ *    @c RGBLED_P_* macros below.
+ *  - The interpreter keeps O(1) RAM per LED (pattern pointer, program counter, deadline and
+ *    one loop counter), so any number of patterns costs flash only.
+ *  - @ref RGBLED_patternValid checks a pattern at compile time through @c static_assert.
+ *  - The interpreter is compiled in with @c RGBLED_ENABLE_PATTERNS=1; @c FADE steps need
+ *    @c RGBLED_ENABLE_FADE=1 as well, otherwise they switch to the color at once.
+ *
+ * Instruction set (operands are bytes; 16-bit values are little-endian):
+ *
+ * | Opcode               | Operands             | Effect                                          |
+ * |----------------------|----------------------|-------------------------------------------------|
+ * | @c RGBLED_OP_END     | -                    | Stop the pattern (LED keeps its last state).     |
+ * | @c RGBLED_OP_COLOR   | r, g, b              | Show color (like @ref RGBLED::setRGB).            |
+ * | @c RGBLED_OP_OFF     | -                    | Turn the LED OFF.                                |
+ * | @c RGBLED_OP_HOLD    | ms_lo, ms_hi         | Wait @c ms milliseconds.                          |
+ * | @c RGBLED_OP_FADE    | r, g, b, ms_lo, ms_hi| Fade to color over @c ms and wait for it.         |
+ * | @c RGBLED_OP_REPEAT  | count, target        | Run bytes [target, here) @c count times in total. |
+ * | @c RGBLED_OP_JUMP    | target               | Continue at @c target; ends an open @c REPEAT.    |
+ *
+ * @code
+ *   // Double blink in red, then a 1 s pause, forever.
+ *   static constexpr uint8_t DOUBLE_RED[] PROGMEM = {
+ *     RGBLED_P_COLOR(255, 0, 0), RGBLED_P_HOLD(100),   // offset 0
+ *     RGBLED_P_OFF(),            RGBLED_P_HOLD(100),
+ *     RGBLED_P_REPEAT(2, 0),
+ *     RGBLED_P_HOLD(1000),
+ *     RGBLED_P_JUMP(0)
+ *   };
+ *   static_assert(RGBLED_patternValid(DOUBLE_RED, sizeof(DOUBLE_RED)), "DOUBLE_RED is malformed");
+ *
+ *   led.playPattern(DOUBLE_RED);
+ * @endcode
+ *
+ * @note Only one @c REPEAT may be active at a time (no nesting); the validator rejects
+ *       patterns whose repeat bodies contain another @c REPEAT. A @c JUMP inside a repeat
+ *       body (e.g. to break out of it) ends the loop, so the next @c REPEAT counts afresh.
+ * @note Patterns are limited to 255 bytes (jump targets are one byte).
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <Arduino.h>
+
+// ###########################################################################
+// Opcodes & authoring macros
+// ###########################################################################
+
+#define RGBLED_OP_END     0x00
+#define RGBLED_OP_COLOR   0x01
+#define RGBLED_OP_OFF     0x02
+#define RGBLED_OP_HOLD    0x03
+#define RGBLED_OP_FADE    0x04
+#define RGBLED_OP_REPEAT  0x05
+#define RGBLED_OP_JUMP    0x06
+
+#define RGBLED_P_END()              RGBLED_OP_END
+#define RGBLED_P_COLOR(r, g, b)     RGBLED_OP_COLOR, (uint8_t)(r), (uint8_t)(g), (uint8_t)(b)
+#define RGBLED_P_OFF()              RGBLED_OP_OFF
+#define RGBLED_P_HOLD(ms)           RGBLED_OP_HOLD, (uint8_t)((ms) & 0xFF), (uint8_t)(((ms) >> 8) & 0xFF)
+#define RGBLED_P_FADE(r, g, b, ms)  RGBLED_OP_FADE, (uint8_t)(r), (uint8_t)(g), (uint8_t)(b), \
+                                    (uint8_t)((ms) & 0xFF), (uint8_t)(((ms) >> 8) & 0xFF)
+#define RGBLED_P_REPEAT(count, target) RGBLED_OP_REPEAT, (uint8_t)(count), (uint8_t)(target)
+#define RGBLED_P_JUMP(target)       RGBLED_OP_JUMP, (uint8_t)(target)
+
+// ###########################################################################
+// Compile-time validator
+// ###########################################################################
+
+/**
+ * @brief Size in bytes of the instruction with opcode @p op, or 0 if @p op is unknown.
+ */
+constexpr uint8_t RGBLED_patternOpSize(uint8_t op)
+{
+  return op == RGBLED_OP_END    ? 1 :
+         op == RGBLED_OP_COLOR  ? 4 :
+         op == RGBLED_OP_OFF    ? 1 :
+         op == RGBLED_OP_HOLD   ? 3 :
+         op == RGBLED_OP_FADE   ? 6 :
+         op == RGBLED_OP_REPEAT ? 3 :
+         op == RGBLED_OP_JUMP   ? 2 : 0;
+}
+
+/**
+ * @brief True if byte offset @p target is the start of an instruction (walks from @p pc).
+ */
+constexpr bool RGBLED_patternIsBoundary(const uint8_t* p, size_t n, size_t target, size_t pc = 0)
+{
+  return pc == target ? true :
+         (pc > target || pc >= n || RGBLED_patternOpSize(p[pc]) == 0) ? false :
+         RGBLED_patternIsBoundary(p, n, target, pc + RGBLED_patternOpSize(p[pc]));
+}
+
+/**
+ * @brief True if any @c REPEAT starts in [from, to).
+ */
+constexpr bool RGBLED_patternHasRepeat(const uint8_t* p, size_t from, size_t to)
+{
+  return from >= to ? false :
+         p[from] == RGBLED_OP_REPEAT ? true :
+         RGBLED_patternHasRepeat(p, from + RGBLED_patternOpSize(p[from]), to);
+}
+
+/**
+ * @brief True if the instruction at @p pc has valid operands.
+ */
+constexpr bool RGBLED_patternOpValid(const uint8_t* p, size_t n, size_t pc)
+{
+  return p[pc] == RGBLED_OP_REPEAT
+           ? (p[pc + 1] > 0 && p[pc + 2] < pc &&
+              RGBLED_patternIsBoundary(p, n, p[pc + 2]) &&
+              !RGBLED_patternHasRepeat(p, p[pc + 2], pc))
+         : p[pc] == RGBLED_OP_JUMP
+           ? (p[pc + 1] < n && RGBLED_patternIsBoundary(p, n, p[pc + 1]))
+         : true;
+}
+
+/**
+ * @brief Validate a pattern: known opcodes, complete operands, jump/repeat targets on
+ *        instruction boundaries, no nested repeats, and no way to run off the end.
+ * @param p  Pattern bytes.
+ * @param n  Pattern size in bytes (1..255).
+ * @param pc Internal recursion cursor; leave at 0.
+ * @return true if @ref RGBLED::playPattern can interpret the pattern safely.
+ */
+constexpr bool RGBLED_patternValid(const uint8_t* p, size_t n, size_t pc = 0)
+{
+  return (n == 0 || n > 255 || pc >= n) ? false :
+         RGBLED_patternOpSize(p[pc]) == 0 ? false :
+         pc + RGBLED_patternOpSize(p[pc]) > n ? false :
+         !RGBLED_patternOpValid(p, n, pc) ? false :
+         (p[pc] == RGBLED_OP_END || p[pc] == RGBLED_OP_JUMP) && pc + RGBLED_patternOpSize(p[pc]) == n ? true :
+         RGBLED_patternValid(p, n, pc + RGBLED_patternOpSize(p[pc]));
+}
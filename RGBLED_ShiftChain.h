@@ -0,0 +1,342 @@
+#pragma once
+
+/**
+ * @file RGBLED_ShiftChain.h
+ * @brief Many RGB LEDs on a chain of 74HC595-style shift registers, with BAM dimming.
+ * @details
+ *  - Channel @c c (LED @c c/3, colour @c c%3) is output @c Q(c%8) of register @c c/8; register 0
+ *    is the one wired to the MCU.
+ *  - The frame buffer holds @p BITS bit planes. @ref RGBLED_ShiftChain::setChannel updates
+ *    them in place and marks the frame dirty; nothing is clocked out until the next
+ *    @ref RGBLED_ShiftChain::flush or @ref RGBLED_ShiftChain::tick.
+ *  - @ref RGBLED_ShiftChain::flush sends one ON/OFF frame (any non-zero duty is ON) and does
+ *    nothing while the frame is clean. Use it with @c BITS = 1 or for static colours.
+ *  - @ref RGBLED_ShiftChain::tick implements bit-angle modulation: it latches plane @c b and
+ *    returns its weight @c 2^b in ticks. A frame is @c 2^BITS-1 ticks and costs
+ *    @c BITS * BYTES bytes on the wire.
+ *  - The wire is a transport policy (no virtual calls): @ref RGBLED_ShiftBitBang or
+ *    @ref RGBLED_ShiftSPI, or any class with @c begin/start/write/latch.
+ *  - @ref RGBLED_ChainSlotDriver (RGBLED_Driver.h) lets an @ref RGBLED or @ref RGBLED_Fixed
+ *    drive one slot of the chain through its PWM path.
+ *
+ * @code
+ *   RGBLED_ShiftChain<16, RGBLED_ShiftBitBang<11, 13, 10> > chain;  // 16 LEDs = 6 registers
+ *
+ *   void setup() { chain.begin(); chain.setRGB(0, 255, 0, 0); chain.flush(); }
+ * @endcode
+ *
+ * @note Refresh is bound by the wire: one plane is @c BYTES bytes, and the shortest BAM slot
+ *       (1 tick) must be longer than the time to send them.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+// ###########################################################################
+// Transports
+// ###########################################################################
+
+/**
+ * @class RGBLED_ShiftBitBang
+ * @brief Bit-banged transport on three GPIO pins (data, clock, latch).
+ * @details On AVR the pins are resolved to port registers in @c begin(), so a byte costs
+ *          8 register read-modify-writes per line instead of 16 @c digitalWrite calls.
+ */
+template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, uint8_t LATCH_PIN>
+class RGBLED_ShiftBitBang
+{
+  public:
+
+    /** @brief Configure the three pins as outputs, clock and latch LOW. */
+    void begin(void)
+    {
+      digitalWrite(CLOCK_PIN, LOW);
+      digitalWrite(LATCH_PIN, LOW);
+      pinMode(DATA_PIN,  OUTPUT);
+      pinMode(CLOCK_PIN, OUTPUT);
+      pinMode(LATCH_PIN, OUTPUT);
+#if RGBLED_FAST_GPIO
+      _outD = portOutputRegister(digitalPinToPort(DATA_PIN));
+      _outC = portOutputRegister(digitalPinToPort(CLOCK_PIN));
+      _maskD = digitalPinToBitMask(DATA_PIN);
+      _maskC = digitalPinToBitMask(CLOCK_PIN);
+#endif
+    }
+
+    /** @brief Start of a frame (nothing to do). */
+    void start(void) {}
+
+    /** @brief Shift one byte out, MSB first (bit 7 ends up on Q7). */
+    void write(uint8_t v)
+    {
+#if RGBLED_FAST_GPIO
+      // Callers may be the main loop and a timer ISR; keep each byte atomic.
+      const uint8_t oldSREG = SREG;
+      cli();
+      for (uint8_t m = 0x80; m; m >>= 1)
+      {
+        if (v & m) *_outD |= _maskD; else *_outD &= (uint8_t)~_maskD;
+        *_outC |= _maskC;
+        *_outC &= (uint8_t)~_maskC;
+      }
+      SREG = oldSREG;
+#else
+      shiftOut(DATA_PIN, CLOCK_PIN, MSBFIRST, v);
+#endif
+    }
+
+    /** @brief Pulse the latch: all registers show the bytes shifted so far. */
+    void latch(void)
+    {
+      digitalWrite(LATCH_PIN, HIGH);
+      digitalWrite(LATCH_PIN, LOW);
+    }
+
+  private:
+
+#if RGBLED_FAST_GPIO
+    volatile uint8_t* _outD = nullptr;  ///< Output register of the data pin.
+    volatile uint8_t* _outC = nullptr;  ///< Output register of the clock pin.
+    uint8_t _maskD = 0, _maskC = 0;     ///< Bit masks of data and clock pins.
+#endif
+};
+
+#if defined(SPI_HAS_TRANSACTION)
+/**
+ * @class RGBLED_ShiftSPI
+ * @brief Hardware SPI transport (MOSI -> SER, SCK -> SRCLK) plus one latch pin.
+ * @details Available when @c <SPI.h> is included before this header. Each frame is one SPI
+ *          transaction; do not share the bus with devices used from other interrupts.
+ * @tparam LATCH_PIN Pin wired to RCLK of all registers.
+ * @tparam CLOCK_HZ  SPI clock (74HC595 is good for well above 8 MHz at 5 V).
+ */
+template <uint8_t LATCH_PIN, uint32_t CLOCK_HZ = 8000000UL>
+class RGBLED_ShiftSPI
+{
+  public:
+
+    /** @brief Start the SPI peripheral and configure the latch pin. */
+    void begin(void)
+    {
+      digitalWrite(LATCH_PIN, LOW);
+      pinMode(LATCH_PIN, OUTPUT);
+      SPI.begin();
+    }
+
+    /** @brief Open the SPI transaction of one frame. */
+    void start(void) { SPI.beginTransaction(SPISettings(CLOCK_HZ, MSBFIRST, SPI_MODE0)); }
+
+    /** @brief Send one byte. */
+    void write(uint8_t v) { SPI.transfer(v); }
+
+    /** @brief Close the transaction and pulse the latch. */
+    void latch(void)
+    {
+      SPI.endTransaction();
+      digitalWrite(LATCH_PIN, HIGH);
+      digitalWrite(LATCH_PIN, LOW);
+    }
+};
+#endif
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_ShiftChain
+ * @brief Frame buffer and BAM engine for @p LEDS RGB LEDs on daisy-chained shift registers.
+ * @tparam LEDS        Number of RGB LEDs (3 channels each).
+ * @tparam TRANSPORT   Wire policy with @c begin(), @c start(), @c write(uint8_t), @c latch().
+ * @tparam BITS        Dimming depth in bit planes (1 = ON/OFF only, up to 8).
+ * @tparam ACTIVE_MODE @ref RGBLED_ACTIVE_LOW inverts every output bit (registers sinking
+ *                     current from common-anode LEDs).
+ */
+template <uint16_t LEDS, class TRANSPORT, uint8_t BITS = 8, RGBLED_ActiveMode ACTIVE_MODE = RGBLED_ACTIVE_HIGH>
+class RGBLED_ShiftChain
+{
+    static_assert(LEDS > 0 && LEDS <= 21845, "RGBLED_ShiftChain: LEDS must be 1..21845");
+    static_assert(BITS >= 1 && BITS <= 8, "RGBLED_ShiftChain: BITS must be 1..8");
+    static_assert(ACTIVE_MODE == RGBLED_ACTIVE_HIGH || ACTIVE_MODE == RGBLED_ACTIVE_LOW,
+                  "RGBLED_ShiftChain: invalid active mode");
+
+    static constexpr uint8_t MAX_LEVEL = (uint8_t)((1u << BITS) - 1); ///< Highest stored level.
+    static constexpr uint8_t INVERT    = (ACTIVE_MODE == RGBLED_ACTIVE_LOW) ? 0xFF : 0x00;
+
+  public:
+
+    static constexpr uint16_t CHANNELS = (uint16_t)(LEDS * 3);      ///< Output bits in use.
+    static constexpr uint16_t BYTES    = (uint16_t)((CHANNELS + 7) / 8); ///< Registers in the chain.
+
+    // -----------------------------------------------------------------------
+    // Setup
+    // -----------------------------------------------------------------------
+
+    /** @brief Start the transport and clock out an all-OFF frame. */
+    void begin(void)
+    {
+      _transport.begin();
+      clear();
+      flush();
+    }
+
+    /** @brief Access the transport, e.g. to configure it. */
+    TRANSPORT& transport(void) { return _transport; }
+
+    // -----------------------------------------------------------------------
+    // Frame buffer
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Set the duty of one channel.
+     * @param ch   Channel index (LED * 3 + colour).
+     * @param duty 0..255; reduced to @p BITS bits, rounding up so any non-zero duty stays ON.
+     */
+    void setChannel(uint16_t ch, uint8_t duty)
+    {
+      if (ch >= CHANNELS) return;
+      const uint8_t level = (BITS == 8) ? duty : (uint8_t)(((uint16_t)duty * MAX_LEVEL + 254) / 255);
+
+      const uint16_t i    = ch >> 3;
+      const uint8_t  mask = (uint8_t)(1u << (ch & 7));
+      uint8_t changed = 0;
+      for (uint8_t b = 0; b < BITS; ++b)
+      {
+        // tick() may shift this plane out mid-update; it sees the old or the new byte, never
+        // half of one, so at worst one BAM period shows the channel between two levels.
+        const uint8_t v = _planes[b][i];
+        const uint8_t n = (level & (1u << b)) ? (uint8_t)(v | mask) : (uint8_t)(v & ~mask);
+        changed |= (uint8_t)(v ^ n);
+        _planes[b][i] = n;
+      }
+      if (changed) _dirty = true;
+    }
+
+    /**
+     * @brief Set the colour of one LED.
+     * @param led LED index (0..LEDS-1).
+     */
+    void setRGB(uint16_t led, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if (led >= LEDS) return;
+      const uint16_t ch = (uint16_t)(led * 3);
+      setChannel(ch,     r);
+      setChannel(ch + 1, g);
+      setChannel(ch + 2, b);
+    }
+
+    /** @brief Stored level of a channel, scaled back to 0..255. */
+    uint8_t channel(uint16_t ch) const
+    {
+      if (ch >= CHANNELS) return 0;
+      const uint16_t i    = ch >> 3;
+      const uint8_t  mask = (uint8_t)(1u << (ch & 7));
+      uint8_t level = 0;
+      for (uint8_t b = 0; b < BITS; ++b) if (_planes[b][i] & mask) level |= (uint8_t)(1u << b);
+      return (BITS == 8) ? level : (uint8_t)((uint16_t)level * 255 / MAX_LEVEL);
+    }
+
+    /** @brief Set every channel to 0 (marks the frame dirty). */
+    void clear(void)
+    {
+      for (uint8_t b = 0; b < BITS; ++b)
+        for (uint16_t i = 0; i < BYTES; ++i) _planes[b][i] = 0;
+      _dirty = true;
+    }
+
+    /** @brief True if the frame changed since the last @ref flush. */
+    bool dirty(void) const { return _dirty; }
+
+    // -----------------------------------------------------------------------
+    // Output
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Clock out an ON/OFF frame if anything changed since the last flush.
+     * @details A channel is ON if its level is non-zero. Sends @c BYTES bytes and one latch.
+     * @retval true  Frame sent.
+     * @retval false Frame was clean; nothing sent.
+     */
+    bool flush(void)
+    {
+      if (!_dirty) return false;
+      _dirty = false;
+
+      _transport.start();
+      for (uint16_t i = BYTES; i-- > 0; )   // farthest register first
+      {
+        uint8_t v = 0;
+        for (uint8_t b = 0; b < BITS; ++b) v |= _planes[b][i];
+        _transport.write((uint8_t)(v ^ INVERT));
+      }
+      _transport.latch();
+      _bytesSent += BYTES;
+      ++_frames;
+      return true;
+    }
+
+    /**
+     * @brief Show the next BAM bit plane (call from a timer interrupt).
+     * @details Sends @c BYTES bytes and latches them. The next call must follow after the
+     *          returned number of ticks; a full frame is @c 2^BITS-1 ticks.
+     * @return Weight of the plane just shown (1, 2, 4, ...).
+     */
+    uint8_t tick(void)
+    {
+      const uint8_t bit = _bit;
+      const uint8_t* plane = _planes[bit];
+
+      _transport.start();
+      for (uint16_t i = BYTES; i-- > 0; ) _transport.write((uint8_t)(plane[i] ^ INVERT));
+      _transport.latch();
+
+      _bytesSent += BYTES;
+      _bit = (uint8_t)((bit + 1 == BITS) ? 0 : bit + 1);
+      if (_bit == 0) ++_frames;
+      return (uint8_t)(1u << bit);
+    }
+
+    // -----------------------------------------------------------------------
+    // Statistics
+    // -----------------------------------------------------------------------
+
+    /** @brief Bytes clocked out since the last @ref resetStats (read with interrupts masked). */
+    uint32_t bytesSent(void) const
+    {
+      noInterrupts();
+      const uint32_t v = _bytesSent;
+      interrupts();
+      return v;
+    }
+
+    /** @brief Frames completed (flushes, or full BAM cycles) since the last @ref resetStats. */
+    uint32_t frames(void) const
+    {
+      noInterrupts();
+      const uint32_t v = _frames;
+      interrupts();
+      return v;
+    }
+
+    /** @brief Reset @ref bytesSent and @ref frames. */
+    void resetStats(void)
+    {
+      noInterrupts();
+      _bytesSent = 0;
+      _frames    = 0;
+      interrupts();
+    }
+
+  private:
+
+    uint8_t  _planes[BITS][BYTES];    ///< Bit plane b holds bit b of every channel level.
+    TRANSPORT _transport;             ///< Wire policy.
+    volatile uint32_t _bytesSent = 0; ///< See bytesSent().
+    volatile uint32_t _frames = 0;    ///< See frames().
+    volatile uint8_t _bit = 0;        ///< Plane shown by the next tick().
+    bool     _dirty = true;           ///< Frame changed since the last flush().
+};
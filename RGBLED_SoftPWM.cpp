@@ -0,0 +1,131 @@
+
+// #################################################################################
+// Include libraries:
+
+#include "RGBLED_SoftPWM.h"
+
+// ##################################################################################
+// RGBLED_SoftPWM Class:
+
+int8_t RGBLED_SoftPWM::addChannel(volatile uint8_t* reg, uint8_t mask)
+{
+  if (!reg || !mask || _channelCount >= RGBLED_SOFTPWM_MAX_CHANNELS) return INVALID_CHANNEL;
+
+  uint8_t p = 0;
+  while (p < _portCount && _portReg[p] != reg) ++p;
+  if (p == _portCount)
+  {
+    if (_portCount >= RGBLED_SOFTPWM_MAX_PORTS) return INVALID_CHANNEL;
+    _portReg[p] = reg;   // publish the register before the ISR can see the new port
+    noInterrupts();
+    _portCount++;
+    interrupts();
+  }
+
+  const uint8_t ch = _channelCount++;
+  _chPort[ch] = p;
+  _chMask[ch] = mask;
+  _duty[ch]   = 0;
+
+  noInterrupts();
+  for (uint8_t b = 0; b < 8; ++b) _bits[b][p] &= (uint8_t)~mask;
+  _portMask[p] |= mask;
+  interrupts();
+
+  return (int8_t)ch;
+}
+
+bool RGBLED_SoftPWM::canAdd(volatile uint8_t* const* regs, uint8_t n) const
+{
+  if ((uint16_t)_channelCount + n > RGBLED_SOFTPWM_MAX_CHANNELS) return false;
+
+  // Count registers that are neither in use nor repeated earlier in the list.
+  uint8_t ports = _portCount;
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    if (!regs[i]) return false;
+    bool known = false;
+    for (uint8_t p = 0; p < _portCount && !known; ++p) known = (_portReg[p] == regs[i]);
+    for (uint8_t j = 0; j < i && !known; ++j) known = (regs[j] == regs[i]);
+    if (!known && ++ports > RGBLED_SOFTPWM_MAX_PORTS) return false;
+  }
+  return true;
+}
+
+void RGBLED_SoftPWM::setDuty(uint8_t ch, uint8_t duty)
+{
+  if (ch >= _channelCount || _duty[ch] == duty) return;
+  _duty[ch] = duty;
+
+  const uint8_t p    = _chPort[ch];
+  const uint8_t mask = _chMask[ch];
+  for (uint8_t b = 0; b < 8; ++b)
+  {
+    // One plane byte per store; the ISR only reads the planes, so a store cannot be lost.
+    const uint8_t v = _bits[b][p];
+    _bits[b][p] = (duty & (1u << b)) ? (uint8_t)(v | mask) : (uint8_t)(v & ~mask);
+  }
+}
+
+void RGBLED_SoftPWM::enableChannel(uint8_t ch, bool en)
+{
+  if (ch >= _channelCount) return;
+  const uint8_t p = _chPort[ch];
+  noInterrupts();
+  if (en) _portMask[p] |= _chMask[ch];
+  else    _portMask[p] &= (uint8_t)~_chMask[ch];
+  interrupts();
+}
+
+uint8_t RGBLED_SoftPWM::isr(void)
+{
+#if RGBLED_SOFTPWM_ISR_TIMING
+  const uint32_t t0 = (uint32_t)RGBLED_SOFTPWM_CYCLES();
+#endif
+  const uint8_t bit = _bit;
+  const uint8_t* out = _bits[bit];
+
+  for (uint8_t p = 0; p < _portCount; ++p)
+  {
+    volatile uint8_t* reg = _portReg[p];
+    *reg = (uint8_t)((*reg & ~_portMask[p]) | (out[p] & _portMask[p]));
+  }
+
+  _bit = (uint8_t)((bit + 1) & 7);
+  _isrCalls = _isrCalls + 1;
+  _frames   = _frames + (uint8_t)(bit == 7);  // frame ends after bit 7
+
+#if RGBLED_SOFTPWM_ISR_TIMING
+  const uint32_t cost = (uint32_t)RGBLED_SOFTPWM_CYCLES() - t0;
+  if (cost < _costMin) _costMin = cost;
+  if (cost > _costMax) _costMax = cost;
+#endif
+
+  return (uint8_t)(1u << bit);
+}
+
+RGBLED_SoftPWM::Stats RGBLED_SoftPWM::stats(void) const
+{
+  Stats s;
+  noInterrupts();
+  s.isrCalls = _isrCalls;
+  s.frames   = _frames;
+#if RGBLED_SOFTPWM_ISR_TIMING
+  s.isrCostMin = (_costMin == 0xFFFFFFFFUL) ? 0 : _costMin;
+  s.isrCostMax = _costMax;
+#endif
+  interrupts();
+  return s;
+}
+
+void RGBLED_SoftPWM::resetStats(void)
+{
+  noInterrupts();
+  _isrCalls = 0;
+  _frames   = 0;
+#if RGBLED_SOFTPWM_ISR_TIMING
+  _costMin  = 0xFFFFFFFFUL;
+  _costMax  = 0;
+#endif
+  interrupts();
+}
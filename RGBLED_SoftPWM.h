@@ -0,0 +1,194 @@
+#pragma once
+
+/**
+ * @file RGBLED_SoftPWM.h
+ * @brief Timer-driven software PWM (bit-angle modulation) for pins without hardware PWM.
+ * @details
+ *  - Serves any number of channels (up to @ref RGBLED_SOFTPWM_MAX_CHANNELS) spread over up to
+ *    @ref RGBLED_SOFTPWM_MAX_PORTS output ports.
+ *  - Bit-angle modulation: bit @c b of every duty is shown for @c 2^b ticks, so a frame of
+ *    255 ticks needs only 8 interrupts, whatever the channel count.
+ *  - A per-bit, per-port mask table is maintained incrementally by @ref setDuty, so the
+ *    interrupt body is a branch-free read-modify-write per port.
+ *  - Cost model: each @ref RGBLED_SoftPWM::isr call does one register read-modify-write per
+ *    port in use, so a frame costs @c 8 x @c portCount() stores (e.g. 24 for three ports),
+ *    independent of the number of channels. With @ref RGBLED_SOFTPWM_ISR_TIMING the min/max
+ *    cost of a call is also measured at run time.
+ *  - @ref RGBLED_SoftPWM::isr is a plain function: call it from your timer ISR on hardware,
+ *    or directly from a host harness on fake registers.
+ *
+ * @code
+ *   RGBLED_SoftPWM softPwm;
+ *   RGBLED led;
+ *
+ *   ISR(TIMER2_COMPA_vect) { OCR2A = softPwm.isr() - 1; }   // 1 tick = 16 us
+ *
+ *   void setup() {
+ *     // ... configure led.parameters, led.init() ...
+ *     led.attachSoftPWM(softPwm);
+ *     led.enablePWM(true);
+ *     // ... start Timer2 in CTC mode, prescaler 256 ...
+ *   }
+ * @endcode
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <Arduino.h>
+
+/**
+ * @def RGBLED_SOFTPWM_MAX_PORTS
+ * @brief Maximum number of distinct output ports served by one engine.
+ */
+#ifndef RGBLED_SOFTPWM_MAX_PORTS
+  #define RGBLED_SOFTPWM_MAX_PORTS 4
+#endif
+
+/**
+ * @def RGBLED_SOFTPWM_MAX_CHANNELS
+ * @brief Maximum number of channels (one pin each) served by one engine.
+ */
+#ifndef RGBLED_SOFTPWM_MAX_CHANNELS
+  #define RGBLED_SOFTPWM_MAX_CHANNELS 24
+#endif
+
+/**
+ * @def RGBLED_SOFTPWM_ISR_TIMING
+ * @brief 1 to record the min/max cost of @ref RGBLED_SoftPWM::isr in its Stats (default 0).
+ * @details Each call reads @ref RGBLED_SOFTPWM_CYCLES on entry and exit. Adds two counter
+ *          reads, two compares and 8 bytes of RAM to the engine.
+ */
+#ifndef RGBLED_SOFTPWM_ISR_TIMING
+  #define RGBLED_SOFTPWM_ISR_TIMING 0
+#endif
+
+/**
+ * @def RGBLED_SOFTPWM_CYCLES
+ * @brief Free-running counter used by @ref RGBLED_SOFTPWM_ISR_TIMING; the cost unit follows it.
+ * @details Defaults to @c micros (4 us resolution on 16 MHz AVR). For cycle resolution name
+ *          a function or expression, e.g. @c -DRGBLED_SOFTPWM_CYCLES=readTimer1 with a function
+ *          returning @c TCNT1 on AVR, or the DWT cycle counter on Cortex-M.
+ */
+#ifndef RGBLED_SOFTPWM_CYCLES
+  #define RGBLED_SOFTPWM_CYCLES micros
+#endif
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_SoftPWM
+ * @brief Bit-angle-modulation engine shared by many channels.
+ */
+class RGBLED_SoftPWM
+{
+  public:
+
+    /// Channel id returned by @ref addChannel when the engine is full.
+    static const int8_t INVALID_CHANNEL = -1;
+
+    /**
+     * @struct Stats
+     * @brief Counters for measuring ISR load and refresh rate.
+     * @details Refresh rate = @c frames / elapsed seconds; the interrupt rate is
+     *          @c isrCalls / elapsed seconds. CPU load = interrupt rate x cost of one call.
+     */
+    struct Stats
+    {
+      uint32_t isrCalls = 0;   ///< Number of @ref isr invocations.
+      uint32_t frames   = 0;   ///< Number of complete 8-bit frames (255 ticks each).
+      uint32_t isrCostMin = 0; ///< Cheapest @ref isr call, in @ref RGBLED_SOFTPWM_CYCLES units (0 if not measured).
+      uint32_t isrCostMax = 0; ///< Most expensive @ref isr call (0 if not measured).
+    };
+
+    // -----------------------------------------------------------------------
+    // Configuration (call from setup, not from interrupts)
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Register one output pin by its port register and bit mask.
+     * @param reg  Output register of the pin's port.
+     * @param mask Bit mask of the pin inside @p reg.
+     * @return Channel id (consecutive from 0), or @ref INVALID_CHANNEL if no room is left.
+     * @post   The channel starts at duty 0 and enabled.
+     */
+    int8_t addChannel(volatile uint8_t* reg, uint8_t mask);
+
+    /**
+     * @brief Check that @p n channels on the given port registers would all fit.
+     * @details Lets a caller register a group of pins (e.g. the three of an LED) all or
+     *          nothing, since channels cannot be removed again.
+     * @param regs Output register of each pin.
+     * @param n    Number of pins.
+     * @return true if @ref addChannel would succeed for every one of them.
+     */
+    bool canAdd(volatile uint8_t* const* regs, uint8_t n) const;
+
+    /**
+     * @brief Set the duty of one channel (0..255).
+     * @details Updates the 8 per-bit masks of the channel's port in place; each mask byte is
+     *          stored atomically, so the ISR shows at most one mixed frame.
+     */
+    void setDuty(uint8_t ch, uint8_t duty);
+
+    /** @brief Last duty set for channel @p ch. */
+    uint8_t duty(uint8_t ch) const { return (ch < _channelCount) ? _duty[ch] : 0; }
+
+    /**
+     * @brief Include or exclude a channel from ISR writes.
+     * @details Disabled pins are left untouched by the ISR and may be driven by other code.
+     */
+    void enableChannel(uint8_t ch, bool en);
+
+    /** @brief Number of registered channels. */
+    uint8_t channelCount(void) const { return _channelCount; }
+
+    /** @brief Number of distinct ports in use. */
+    uint8_t portCount(void) const { return _portCount; }
+
+    // -----------------------------------------------------------------------
+    // Interrupt entry point
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Output the next BAM bit on every port.
+     * @return Number of ticks until the next call (1, 2, 4, ... 128). Program the timer
+     *         compare with this value; a full frame is 255 ticks.
+     */
+    uint8_t isr(void);
+
+    // -----------------------------------------------------------------------
+    // Statistics
+    // -----------------------------------------------------------------------
+
+    /** @brief Snapshot of the ISR counters (taken with interrupts masked). */
+    Stats stats(void) const;
+
+    /** @brief Reset the ISR counters. */
+    void resetStats(void);
+
+  private:
+
+    volatile uint8_t* _portReg[RGBLED_SOFTPWM_MAX_PORTS];        ///< Output register per port.
+    uint8_t _portMask[RGBLED_SOFTPWM_MAX_PORTS] = {0};           ///< Enabled channel bits per port.
+    uint8_t _bits[8][RGBLED_SOFTPWM_MAX_PORTS] = {{0}};          ///< Output bits per BAM bit and port.
+    uint8_t _portCount = 0;
+
+    uint8_t _chPort[RGBLED_SOFTPWM_MAX_CHANNELS];                ///< Port index per channel.
+    uint8_t _chMask[RGBLED_SOFTPWM_MAX_CHANNELS];                ///< Pin mask per channel.
+    uint8_t _duty[RGBLED_SOFTPWM_MAX_CHANNELS];                  ///< Duty per channel.
+    uint8_t _channelCount = 0;
+
+    volatile uint8_t  _bit = 0;       ///< BAM bit shown by the next isr() call.
+    volatile uint32_t _isrCalls = 0;  ///< See Stats::isrCalls.
+    volatile uint32_t _frames = 0;    ///< See Stats::frames.
+#if RGBLED_SOFTPWM_ISR_TIMING
+    volatile uint32_t _costMin = 0xFFFFFFFFUL; ///< See Stats::isrCostMin.
+    volatile uint32_t _costMax = 0;            ///< See Stats::isrCostMax.
+#endif
+};
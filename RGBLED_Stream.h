@@ -0,0 +1,247 @@
+#pragma once
+
+/**
+ * @file RGBLED_Stream.h
+ * @brief Incremental decoder for binary colour frames pushed from a host (e.g. over serial).
+ * @details
+ *  - Frames follow RGBLED_StreamProtocol.h: sync, type, LED range, packed RGB, CRC-16.
+ *  - The decoder consumes one byte at a time and keeps only a 3-byte pixel in flight. Each
+ *    completed pixel goes to the sink with @c stageRGB, which does not output it; the range
+ *    is shown with @c showRange only after the CRC matched, so a corrupted frame never
+ *    reaches the LEDs.
+ *  - @ref RGBLEDGroup writes pixels straight into its colour cache: a dropped frame's pixels
+ *    stay there (in the power estimate, and shown by a blinking member's ON edge) until the
+ *    next valid frame for those LEDs. @c RGBLEDGroup<N, true> holds them in a staging copy
+ *    (3*N bytes) instead, so a dropped frame leaves no trace.
+ *  - A sink is any class with (no base class, no virtual calls):
+ *    - @c uint8_t size() const : number of addressable LEDs.
+ *    - @c void stageRGB(uint8_t i, uint8_t r, uint8_t g, uint8_t b) : take a colour without
+ *      outputting it.
+ *    - @c void showRange(uint8_t first, uint8_t count) : output the colours of the range.
+ *    @ref RGBLEDGroup is a sink; @ref RGBLED_StreamLed adapts a single @ref RGBLED.
+ *  - Errors (bad type, range outside the sink, CRC mismatch) drop the frame, are counted,
+ *    and the decoder waits for the next sync byte. Colours of a dropped frame are never
+ *    shown by the decoder; the next valid frame for those LEDs replaces them.
+ *
+ * @code
+ *   RGBLEDGroup<8> panel;
+ *   RGBLED_StreamDecoder<RGBLEDGroup<8>> decoder(panel);
+ *
+ *   void loop() {
+ *     decoder.poll(Serial);   // reads what is available, never blocks
+ *     panel.update();
+ *   }
+ * @endcode
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+#include "RGBLED_StreamProtocol.h"
+
+// ###########################################################################
+// Sinks
+// ###########################################################################
+
+/**
+ * @class RGBLED_StreamLed
+ * @brief Stream sink for one @ref RGBLED (index 0).
+ */
+class RGBLED_StreamLed
+{
+  public:
+
+    /** @brief Bind to an LED; it must outlive the sink. */
+    explicit RGBLED_StreamLed(RGBLED& led) : _led(&led) {}
+
+    /** @brief One addressable LED. */
+    uint8_t size(void) const { return 1; }
+
+    /** @brief Keep the colour until the frame is verified. */
+    void stageRGB(uint8_t, uint8_t r, uint8_t g, uint8_t b)
+    {
+      _rgb[0] = r; _rgb[1] = g; _rgb[2] = b;
+    }
+
+    /** @brief Show the staged colour. */
+    void showRange(uint8_t, uint8_t) { _led->setRGB(_rgb[0], _rgb[1], _rgb[2]); }
+
+  private:
+
+    RGBLED* _led;                    ///< Output LED.
+    uint8_t _rgb[3] = {0, 0, 0};     ///< Staged colour.
+};
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_StreamDecoder
+ * @brief Byte-at-a-time frame decoder writing into a sink.
+ * @tparam SINK Sink type (see the file description).
+ */
+template <class SINK>
+class RGBLED_StreamDecoder
+{
+  public:
+
+    /**
+     * @enum Result
+     * @brief Outcome of feeding one byte.
+     */
+    enum Result : uint8_t
+    {
+      RESULT_NONE  = 0,  /**< Byte consumed; frame not finished. */
+      RESULT_FRAME = 1,  /**< Byte completed a valid frame; its range was shown. */
+      RESULT_ERROR = 2   /**< Byte revealed a bad frame; it was dropped. */
+    };
+
+    /**
+     * @brief Bind the decoder to a sink.
+     * @param sink Destination; must outlive the decoder.
+     */
+    explicit RGBLED_StreamDecoder(SINK& sink) : _sink(&sink) {}
+
+    /**
+     * @brief Consume one byte.
+     * @return @ref RESULT_FRAME when the byte completed a valid frame, @ref RESULT_ERROR
+     *         when a frame was dropped, otherwise @ref RESULT_NONE.
+     */
+    Result feed(uint8_t byte)
+    {
+      switch (_state)
+      {
+        case S_SYNC:
+          if (byte == RGBLED_STREAM_SYNC) { _crc = 0xFFFF; _state = S_TYPE; }
+          return RESULT_NONE;
+
+        case S_TYPE:
+          if (byte == RGBLED_STREAM_SYNC) return RESULT_NONE;  // repeated sync: still a frame start
+          if (byte != RGBLED_STREAM_RGB) return _fail(_headerErrors);
+          _crc = RGBLED_crc16Update(_crc, byte);
+          _state = S_FIRST;
+          return RESULT_NONE;
+
+        case S_FIRST:
+          _first = byte;
+          _crc = RGBLED_crc16Update(_crc, byte);
+          _state = S_COUNT;
+          return RESULT_NONE;
+
+        case S_COUNT:
+          if (byte == 0 || (uint16_t)_first + byte > _sink->size()) return _fail(_headerErrors);
+          _count = byte;
+          _crc = RGBLED_crc16Update(_crc, byte);
+          _index = _first;
+          _sub = 0;
+          _state = S_PAYLOAD;
+          return RESULT_NONE;
+
+        case S_PAYLOAD:
+          _crc = RGBLED_crc16Update(_crc, byte);
+          _px[_sub] = byte;
+          if (++_sub == 3)
+          {
+            _sub = 0;
+            _sink->stageRGB(_index, _px[0], _px[1], _px[2]);
+            if ((uint8_t)(++_index - _first) == _count) _state = S_CRC_HI;
+          }
+          return RESULT_NONE;
+
+        case S_CRC_HI:
+          _px[0] = byte;
+          _state = S_CRC_LO;
+          return RESULT_NONE;
+
+        case S_CRC_LO:
+        default:
+          if ((uint16_t)((_px[0] << 8) | byte) != _crc) return _fail(_crcErrors);
+          _state = S_SYNC;
+          _sink->showRange(_first, _count);
+          ++_frames;
+          return RESULT_FRAME;
+      }
+    }
+
+    /**
+     * @brief Consume a buffer.
+     * @return Number of valid frames completed.
+     */
+    uint16_t feed(const uint8_t* data, uint16_t len)
+    {
+      uint16_t frames = 0;
+      for (uint16_t i = 0; i < len; ++i)
+      {
+        if (feed(data[i]) == RESULT_FRAME) ++frames;
+      }
+      return frames;
+    }
+
+    /**
+     * @brief Consume the bytes already received by a stream (e.g. @c Serial); never blocks.
+     * @param stream Object with @c available() and @c read().
+     * @param budget Maximum bytes per call, to bound the time spent in @c loop().
+     * @return Number of valid frames completed.
+     */
+    template <class STREAM>
+    uint16_t poll(STREAM& stream, uint16_t budget = 256)
+    {
+      uint16_t frames = 0;
+      int avail = stream.available();
+      if (avail > (int)budget) avail = budget;
+      while (avail-- > 0)
+      {
+        const int c = stream.read();
+        if (c < 0) break;
+        if (feed((uint8_t)c) == RESULT_FRAME) ++frames;
+      }
+      return frames;
+    }
+
+    /** @brief Drop a partial frame and wait for the next sync byte. */
+    void reset(void) { _state = S_SYNC; }
+
+    // -----------------------------------------------------------------------
+    // Statistics
+    // -----------------------------------------------------------------------
+
+    /** @brief Valid frames shown. */
+    uint32_t frames(void) const { return _frames; }
+
+    /** @brief Frames dropped for a CRC mismatch. */
+    uint16_t crcErrors(void) const { return _crcErrors; }
+
+    /** @brief Frames dropped for an unknown type or an LED range outside the sink. */
+    uint16_t headerErrors(void) const { return _headerErrors; }
+
+    /** @brief Reset the counters. */
+    void resetStats(void) { _frames = 0; _crcErrors = _headerErrors = 0; }
+
+  private:
+
+    enum : uint8_t { S_SYNC, S_TYPE, S_FIRST, S_COUNT, S_PAYLOAD, S_CRC_HI, S_CRC_LO };
+
+    SINK*    _sink;                  ///< Destination of decoded colours.
+    uint32_t _frames = 0;            ///< Valid frame counter.
+    uint16_t _crc = 0xFFFF;          ///< Running CRC of the current frame.
+    uint16_t _crcErrors = 0;         ///< CRC mismatch counter.
+    uint16_t _headerErrors = 0;      ///< Bad header counter.
+    uint8_t  _state = S_SYNC;        ///< Parser state.
+    uint8_t  _first = 0;             ///< First LED of the current frame.
+    uint8_t  _count = 0;             ///< LEDs in the current frame.
+    uint8_t  _index = 0;             ///< LED receiving the next pixel.
+    uint8_t  _sub = 0;               ///< Bytes of the pixel in flight (0..2).
+    uint8_t  _px[3] = {0, 0, 0};     ///< Pixel in flight; _px[0] holds the CRC high byte.
+
+    Result _fail(uint16_t& counter)
+    {
+      if (counter != 0xFFFF) ++counter;
+      _state = S_SYNC;
+      return RESULT_ERROR;
+    }
+};
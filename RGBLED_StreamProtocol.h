@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * @file RGBLED_StreamProtocol.h
+ * @brief Wire format, CRC and encoder of the binary colour stream (see RGBLED_Stream.h).
+ * @details
+ *  This header depends only on @c <stdint.h>, so the same encoder builds into a PC tool that
+ *  drives the board over serial.
+ *
+ *  Frame layout (all fields one byte unless noted):
+ *  | Field   | Value                                                          |
+ *  |---------|----------------------------------------------------------------|
+ *  | sync    | @ref RGBLED_STREAM_SYNC (0xA5)                                 |
+ *  | type    | @ref RGBLED_STREAM_RGB                                         |
+ *  | first   | Index of the first LED                                         |
+ *  | count   | Number of LEDs (1..255)                                        |
+ *  | payload | @c count x (R, G, B)                                           |
+ *  | crc     | CRC-16/CCITT-FALSE over type..payload, 2 bytes, high byte first |
+ *
+ *  The payload is not escaped: a decoder that loses sync discards bytes until the next 0xA5
+ *  and relies on the header checks and the CRC to reject false starts.
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <stdint.h>
+
+// ###########################################################################
+// Constants
+// ###########################################################################
+
+static const uint8_t RGBLED_STREAM_SYNC     = 0xA5;  ///< First byte of every frame.
+static const uint8_t RGBLED_STREAM_RGB      = 0x01;  ///< Frame type: packed RGB for an LED range.
+static const uint8_t RGBLED_STREAM_OVERHEAD = 6;     ///< Bytes per frame besides the payload.
+
+/**
+ * @brief Encoded size of an RGB frame for @p count LEDs.
+ */
+static inline uint16_t RGBLED_streamFrameSize(uint8_t count)
+{
+  return (uint16_t)(RGBLED_STREAM_OVERHEAD + 3u * count);
+}
+
+// ###########################################################################
+// CRC
+// ###########################################################################
+
+/**
+ * @brief Add one byte to a CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection).
+ * @details Table-free shift/xor form: a few instructions per byte and no flash table.
+ */
+static inline uint16_t RGBLED_crc16Update(uint16_t crc, uint8_t data)
+{
+  crc  = (uint16_t)((crc >> 8) | (crc << 8));
+  crc ^= data;
+  crc ^= (uint8_t)(crc & 0xFF) >> 4;
+  crc ^= (uint16_t)(crc << 12);
+  crc ^= (uint16_t)((crc & 0xFF) << 5);
+  return crc;
+}
+
+// ###########################################################################
+// Encoder
+// ###########################################################################
+
+/**
+ * @brief Encode one RGB frame.
+ * @param[out] out   Buffer of at least @ref RGBLED_streamFrameSize(@p count) bytes.
+ * @param first      Index of the first LED.
+ * @param count      Number of LEDs (1..255).
+ * @param rgb        @p count packed (R, G, B) triples.
+ * @return Number of bytes written (0 if @p count is 0).
+ */
+static inline uint16_t RGBLED_streamEncode(uint8_t* out, uint8_t first, uint8_t count, const uint8_t* rgb)
+{
+  if (count == 0) return 0;
+
+  uint8_t* p = out;
+  *p++ = RGBLED_STREAM_SYNC;
+
+  uint16_t crc = 0xFFFF;
+  const uint8_t header[3] = { RGBLED_STREAM_RGB, first, count };
+  for (uint8_t i = 0; i < 3; ++i) { *p++ = header[i]; crc = RGBLED_crc16Update(crc, header[i]); }
+
+  for (uint16_t i = 0; i < 3u * count; ++i) { *p++ = rgb[i]; crc = RGBLED_crc16Update(crc, rgb[i]); }
+
+  *p++ = (uint8_t)(crc >> 8);
+  *p++ = (uint8_t)crc;
+  return (uint16_t)(p - out);
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+/**
+ * @file RGBLED_Timebase.h
+ * @brief Shared clock for phase-locked blinking of many @ref RGBLED objects.
+ * @details
+ *  - LEDs join with a phase offset and an ON time inside one common period, e.g. two LEDs
+ *    half a period apart alternate, N LEDs @c period/N apart chase.
+ *  - The ON/OFF edges of all members within one period are sorted once when the schedule
+ *    changes. At run time a cursor walks that list: the next deadline of the whole timebase
+ *    is one addition (period start + edge offset), and edges due at the same time are applied
+ *    in the same pass.
+ *  - Period starts advance by exactly one period from a fixed origin, so members stay locked
+ *    to each other and to the origin indefinitely; loop lateness delays an edge but never
+ *    shifts the ones after it. After a stall of more than one period the state is recomputed
+ *    directly from the phase instead of replaying missed edges.
+ *  - The phase is a signed offset from the origin taken with a true modulo, so the origin may
+ *    lie in the future. The origin moves forward with every period and re-sync, so the
+ *    offset stays small across @c millis() wraps.
+ *  - Effects are pure functions of time; @ref RGBLED_Timebase::lockEffect puts an LED's effect
+ *    on the same origin with an offset (with @c RGBLED_ENABLE_EFFECTS).
+ *
+ * @code
+ *   RGBLED a, b, c;
+ *   RGBLED_Timebase<3> tb(600);              // 600 ms period
+ *
+ *   void setup() {
+ *     // ... configure, init() and set a colour on a, b, c ...
+ *     tb.join(a,   0, 200);                   // chase: 200 ms each, 200 ms apart
+ *     tb.join(b, 200, 200);
+ *     tb.join(c, 400, 200);
+ *     tb.start();
+ *   }
+ *   void loop() { tb.update(); }
+ * @endcode
+ *
+ * @note Members are driven with @c on() / @c off(); do not also run @ref RGBLED::blink on them.
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include "RGBLED.h"
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_Timebase
+ * @brief Fixed-capacity set of LEDs blinking on one clock with per-LED phase offsets.
+ * @tparam N Maximum number of members (1..128).
+ */
+template <uint8_t N>
+class RGBLED_Timebase
+{
+    static_assert(N > 0 && N <= 128, "RGBLED_Timebase: capacity must be in 1..128");
+
+  public:
+
+    /// Index value returned by @ref join when the timebase is full.
+    static constexpr int16_t INVALID_INDEX = -1;
+
+    /**
+     * @brief Create an idle timebase.
+     * @param period_ms Common period in ms (> 0).
+     */
+    explicit RGBLED_Timebase(uint16_t period_ms = 1000) : _period(period_ms ? period_ms : 1) {}
+
+    // -----------------------------------------------------------------------
+    // Membership and schedule
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Add an initialized LED.
+     * @param led       LED object; must outlive the timebase.
+     * @param offset_ms Start of the ON window inside the period (taken modulo the period).
+     * @param on_ms     Length of the ON window; 0 = always OFF, >= period = always ON.
+     * @return Member index, or @ref INVALID_INDEX if the timebase is full.
+     * @note  A running timebase picks the new member up immediately.
+     */
+    int16_t join(RGBLED& led, uint16_t offset_ms, uint16_t on_ms)
+    {
+      if (_count >= N) return INVALID_INDEX;
+      const uint8_t i = _count++;
+      _leds[i]   = &led;
+      _offset[i] = offset_ms;
+      _on[i]     = on_ms;
+      _rebuild();
+      return i;
+    }
+
+    /**
+     * @brief Change the ON window of member @p i.
+     * @param i         Index returned by @ref join.
+     * @param offset_ms Start of the ON window inside the period.
+     * @param on_ms     Length of the ON window.
+     */
+    void setPhase(uint8_t i, uint16_t offset_ms, uint16_t on_ms)
+    {
+      if (i >= _count) return;
+      _offset[i] = offset_ms;
+      _on[i]     = on_ms;
+      _rebuild();
+    }
+
+    /**
+     * @brief Change the common period; members keep their offsets and ON times in ms.
+     * @param period_ms Period in ms (> 0).
+     */
+    void setPeriod(uint16_t period_ms)
+    {
+      if (period_ms == 0) return;
+      _period = period_ms;
+      _rebuild();
+    }
+
+    /** @brief Number of members. */
+    uint8_t size(void) const { return _count; }
+
+    // -----------------------------------------------------------------------
+    // Running
+    // -----------------------------------------------------------------------
+
+    /**
+     * @brief Start (or re-phase) all members on the clock.
+     * @param origin Time of phase 0 in @c millis() units, past or future, e.g. another
+     *               timebase's @ref origin to lock two timebases together.
+     */
+    void start(uint32_t origin)
+    {
+      _origin  = origin;
+      _running = true;
+      _resync((uint32_t)millis());
+    }
+
+    /** @brief Start with phase 0 now. */
+    void start(void) { start((uint32_t)millis()); }
+
+    /**
+     * @brief Stop the clock.
+     * @param turnOff If true, turns all members OFF; otherwise leaves them as they are.
+     */
+    void stop(bool turnOff = true)
+    {
+      _running = false;
+      if (turnOff) for (uint8_t i = 0; i < _count; ++i) _leds[i]->off();
+    }
+
+    /** @brief True while the clock runs. */
+    bool isRunning(void) const { return _running; }
+
+    /**
+     * @brief Time of phase 0 in @c millis() units.
+     * @details Re-based forward by whole periods as the clock runs (every period and every
+     *          re-sync), so it is a phase 0 within one period of now, not necessarily the
+     *          value passed to @ref start.
+     */
+    uint32_t origin(void) const { return _origin; }
+
+#if RGBLED_ENABLE_EFFECTS
+    /**
+     * @brief Put the running effect of @p led on this clock, @p offset_ms ahead of phase 0.
+     * @details LEDs locked with the same period and offsets stay in phase indefinitely.
+     *          Call after starting the effect (starting resets the effect origin).
+     * @note  @ref origin moves by whole timebase periods as the clock runs; LEDs locked at different
+     *        times stay in phase when the effect period divides the timebase period.
+     */
+    void lockEffect(RGBLED& led, uint16_t offset_ms) const
+    {
+      led.setEffectOrigin(_origin - offset_ms);
+    }
+#endif
+
+    /**
+     * @brief Apply due edges.
+     * @details Reads the clock once and returns after one compare until the next edge.
+     */
+    void update(void)
+    {
+      if (!_running || _edgeCount == 0) return;
+      update((uint32_t)millis());
+    }
+
+    /**
+     * @brief Apply due edges using a caller-supplied clock.
+     * @param now Current time in milliseconds (same timebase as @c millis()).
+     */
+    void update(uint32_t now)
+    {
+      if (!_running || _edgeCount == 0) return;
+      if ((int32_t)(now - _cycleStart) >= (int32_t)(2UL * _period)) { _resync(now); return; }
+
+      while ((int32_t)(now - (_cycleStart + _edgeT[_cursor])) >= 0)
+      {
+        const uint8_t e = _edgeM[_cursor];
+        RGBLED* led = _leds[e & MEMBER_MASK];
+        if (e & EDGE_ON) led->on();
+        else             led->off();
+
+        if (++_cursor == _edgeCount)
+        {
+          _cursor = 0;
+          _cycleStart += _period;  // exact: no accumulation of loop lateness
+          _origin = _cycleStart;   // keep now - _origin small for the next re-sync
+        }
+      }
+    }
+
+    /**
+     * @brief Absolute time of the next edge of any member.
+     * @param[out] deadline Time in @c millis() units; untouched when idle.
+     * @retval true  Running with at least one edge per period.
+     * @retval false Stopped, or every member is constantly ON or OFF.
+     */
+    bool nextDeadlineMs(uint32_t &deadline) const
+    {
+      if (!_running || _edgeCount == 0) return false;
+      deadline = _cycleStart + _edgeT[_cursor];
+      return true;
+    }
+
+  private:
+
+    static constexpr uint8_t EDGE_ON     = 0x80; ///< Edge turns the member ON.
+    static constexpr uint8_t MEMBER_MASK = 0x7F; ///< Member index bits of an edge.
+
+    RGBLED*  _leds[N];            ///< Members.
+    uint16_t _offset[N];          ///< ON window start per member (ms).
+    uint16_t _on[N];              ///< ON window length per member (ms).
+    uint16_t _edgeT[2 * N];       ///< Edge times inside the period, ascending.
+    uint8_t  _edgeM[2 * N];       ///< Member index | EDGE_ON, parallel to _edgeT.
+
+    uint32_t _origin = 0;         ///< Time of phase 0 (re-based forward each period).
+    uint32_t _cycleStart = 0;     ///< Start of the current period (origin + k * period).
+    uint16_t _period;             ///< Common period in ms.
+    uint8_t  _count = 0;          ///< Number of members.
+    uint8_t  _edgeCount = 0;      ///< Valid entries in _edgeT/_edgeM.
+    uint8_t  _cursor = 0;         ///< Next edge in the current period.
+    bool     _running = false;    ///< Clock started.
+
+    /// True if member @p i is inside its ON window at @p phase (0..period-1).
+    bool _litAt(uint8_t i, uint16_t phase) const
+    {
+      if (_on[i] >= _period) return true;
+      const uint16_t start = _offset[i] % _period;
+      const uint16_t rel = (phase >= start) ? (uint16_t)(phase - start) : (uint16_t)(phase + _period - start);
+      return rel < _on[i];
+    }
+
+    /// Rebuild the sorted edge list (insertion sort; runs only when the schedule changes).
+    void _rebuild(void)
+    {
+      _edgeCount = 0;
+      for (uint8_t i = 0; i < _count; ++i)
+      {
+        if (_on[i] == 0 || _on[i] >= _period) continue;  // constant: no edges
+        const uint16_t tOn  = _offset[i] % _period;
+        const uint16_t tOff = (uint16_t)(((uint32_t)tOn + _on[i]) % _period);
+        _insertEdge(tOff, i);
+        _insertEdge(tOn, (uint8_t)(i | EDGE_ON));
+      }
+      if (_running) _resync((uint32_t)millis());
+    }
+
+    void _insertEdge(uint16_t t, uint8_t m)
+    {
+      uint8_t j = _edgeCount++;
+      while (j > 0 && _edgeT[j - 1] > t) { _edgeT[j] = _edgeT[j - 1]; _edgeM[j] = _edgeM[j - 1]; --j; }
+      _edgeT[j] = t;
+      _edgeM[j] = m;
+    }
+
+    /// Set every member from the phase at @p now and point the cursor at the next edge.
+    void _resync(uint32_t now)
+    {
+      // Signed offset and a true modulo: the origin may lie in the future, and re-basing it
+      // keeps the offset small, so it never wraps however long the clock runs.
+      int32_t rem = (int32_t)(now - _origin) % (int32_t)_period;  // one division per resync
+      if (rem < 0) rem += _period;
+      const uint16_t phase = (uint16_t)rem;
+      _cycleStart = now - phase;
+      _origin = _cycleStart;
+
+      for (uint8_t i = 0; i < _count; ++i)
+      {
+        if (_litAt(i, phase)) _leds[i]->on();
+        else                  _leds[i]->off();
+      }
+
+      _cursor = 0;
+      while (_cursor < _edgeCount && _edgeT[_cursor] <= phase) ++_cursor;
+      if (_cursor == _edgeCount)
+      {
+        _cursor = 0;
+        _cycleStart += _period;
+      }
+    }
+};
@@ -0,0 +1,90 @@
+// #################################################################################
+// Include libraries:
+
+#include "RGBLED_Trace.h"
+
+// ##################################################################################
+// RGBLED_Trace Class:
+
+void RGBLED_Trace::record(uint32_t now, uint8_t pin, uint8_t value, bool elided)
+{
+  if (_count == 0) { _base = now; _last = now; }
+
+  uint32_t dt = now - _last;
+  _last = now;
+
+  // Gaps of 255 ms and more go into time entries (up to 65535 ms each).
+  while (dt >= TIME_ENTRY)
+  {
+    const uint16_t gap = (dt > 0xFFFF) ? 0xFFFF : (uint16_t)dt;
+    _push(TIME_ENTRY, (uint8_t)(gap >> 8), (uint8_t)gap);
+    dt -= gap;
+  }
+  _push((uint8_t)dt, (uint8_t)(elided ? (pin | ELIDED) : (pin & ~ELIDED)), value);
+  ++_events;
+}
+
+void RGBLED_Trace::_push(uint8_t delta, uint8_t a, uint8_t b)
+{
+  if (_count == _capacity)
+  {
+    // Drop the oldest entry; its delta moves into the base time.
+    const uint16_t tail = (uint16_t)((_head + _capacity - _count) % _capacity);
+    const uint8_t* e = _slots[tail];
+    _base += _delta(e);
+    if (e[0] != TIME_ENTRY) { --_events; ++_lost; }
+    --_count;
+  }
+
+  uint8_t* e = _slots[_head];
+  e[0] = delta; e[1] = a; e[2] = b;
+  if (++_head == _capacity) _head = 0;
+  ++_count;
+}
+
+void RGBLED_Trace::clear(void)
+{
+  _head = _count = _events = 0;
+  _lost = 0;
+}
+
+uint16_t RGBLED_Trace::read(RGBLED_TraceEvent* out, uint16_t max) const
+{
+  uint16_t n = 0;
+  uint32_t t = _base;
+  uint16_t idx = (uint16_t)((_head + _capacity - _count) % _capacity);
+
+  for (uint16_t i = 0; i < _count && n < max; ++i)
+  {
+    const uint8_t* e = _slots[idx];
+    t += _delta(e);
+    if (e[0] != TIME_ENTRY)
+    {
+      out[n].t = t; out[n].pin = (uint8_t)(e[1] & ~ELIDED); out[n].value = e[2];
+      out[n].elided = (e[1] & ELIDED) != 0;
+      ++n;
+    }
+    if (++idx == _capacity) idx = 0;
+  }
+  return n;
+}
+
+void RGBLED_Trace::dump(Print& out) const
+{
+  uint32_t t = _base;
+  uint16_t idx = (uint16_t)((_head + _capacity - _count) % _capacity);
+
+  for (uint16_t i = 0; i < _count; ++i)
+  {
+    const uint8_t* e = _slots[idx];
+    t += _delta(e);
+    if (e[0] != TIME_ENTRY)
+    {
+      out.print(t);    out.print(',');
+      out.print(e[1] & ~ELIDED); out.print(',');
+      out.print(e[2]); out.print(',');
+      out.println((e[1] & ELIDED) ? 1 : 0);
+    }
+    if (++idx == _capacity) idx = 0;
+  }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file RGBLED_Trace.h
+ * @brief Fixed-size ring buffer recording every hardware write of attached @ref RGBLED objects.
+ * @details
+ *  - Compiled into @ref RGBLED only with @c RGBLED_ENABLE_TRACE=1 (build flag); attach a
+ *    buffer with @c RGBLED::attachTrace. Several LEDs may share one buffer (events carry
+ *    the pin number).
+ *  - Each entry is 3 bytes: time delta to the previous entry in ms (0..254), pin, value.
+ *    Longer gaps insert a time entry (delta 255, 16-bit gap in the other two bytes).
+ *  - Writes skipped by redundant-write elision are recorded too, flagged in bit 7 of the
+ *    pin byte (pins 0..127), so a replay can count them.
+ *  - When full, the oldest entries are overwritten; their time is folded into the base
+ *    time, so the retained events keep exact absolute timestamps.
+ *  - Read back with @ref RGBLED_Trace::read (absolute times) or print as CSV with
+ *    @ref RGBLED_Trace::dump, then check against a schedule with RGBLED_TraceReplay.h.
+ *
+ * @code
+ *   RGBLED_TraceBuffer<128> trace;     // 384 bytes
+ *   led.attachTrace(&trace);
+ *   led.blink(1200, 4, false);
+ *   // ... later
+ *   trace.dump(Serial);                // "t_ms,pin,value,elided" lines, oldest first
+ * @endcode
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <Arduino.h>
+#include "RGBLED_TraceReplay.h"
+
+// ###########################################################################
+// Class Definition
+// ###########################################################################
+
+/**
+ * @class RGBLED_Trace
+ * @brief Delta-encoded ring of (time, pin, value) writes over caller-provided storage.
+ * @note  Use @ref RGBLED_TraceBuffer to get the storage; this base is what LEDs attach to.
+ */
+class RGBLED_Trace
+{
+  public:
+
+    /**
+     * @brief Append one write.
+     * @param now    Time in @c millis() units (non-decreasing).
+     * @param pin    Pin number (0..127).
+     * @param value  PWM duty or HIGH/LOW.
+     * @param elided True if the write was skipped because the pin already held @p value.
+     */
+    void record(uint32_t now, uint8_t pin, uint8_t value, bool elided = false);
+
+    /** @brief Discard all entries. */
+    void clear(void);
+
+    /** @brief Number of retained write events. */
+    uint16_t size(void) const { return _events; }
+
+    /** @brief Number of write events lost to overwriting since the last @ref clear. */
+    uint32_t overwritten(void) const { return _lost; }
+
+    /**
+     * @brief Decode retained events, oldest first, with absolute timestamps.
+     * @param[out] out Destination array.
+     * @param max      Capacity of @p out.
+     * @return Number of events written.
+     */
+    uint16_t read(RGBLED_TraceEvent* out, uint16_t max) const;
+
+    /**
+     * @brief Print retained events as CSV lines @c "t_ms,pin,value,elided", oldest first.
+     * @param out Any @c Print (e.g. @c Serial).
+     */
+    void dump(Print& out) const;
+
+  protected:
+
+    /**
+     * @brief Bind the ring to storage of @p capacity 3-byte entries.
+     */
+    RGBLED_Trace(uint8_t (*slots)[3], uint16_t capacity) : _slots(slots), _capacity(capacity) {}
+
+  private:
+
+    static const uint8_t TIME_ENTRY = 0xFF;  ///< Delta marker of a time-only entry.
+    static const uint8_t ELIDED     = 0x80;  ///< Pin-byte flag of an elided write.
+
+    uint8_t  (*_slots)[3];       ///< Entries: delta, pin, value.
+    uint32_t _base = 0;          ///< Absolute time before the oldest retained entry.
+    uint32_t _last = 0;          ///< Absolute time of the newest entry.
+    uint32_t _lost = 0;          ///< Overwritten events.
+    uint16_t _capacity;          ///< Number of entries.
+    uint16_t _head = 0;          ///< Next entry to write.
+    uint16_t _count = 0;         ///< Retained entries (events and time entries).
+    uint16_t _events = 0;        ///< Retained events.
+
+    void _push(uint8_t delta, uint8_t a, uint8_t b);
+
+    static uint16_t _delta(const uint8_t* e)
+    {
+      return (e[0] == TIME_ENTRY) ? (uint16_t)((e[1] << 8) | e[2]) : e[0];
+    }
+};
+
+/**
+ * @class RGBLED_TraceBuffer
+ * @brief @ref RGBLED_Trace with @p N entries of inline storage (3*N bytes).
+ * @tparam N Number of entries (1..65535).
+ */
+template <uint16_t N>
+class RGBLED_TraceBuffer : public RGBLED_Trace
+{
+    static_assert(N > 0, "RGBLED_TraceBuffer: N must be at least 1");
+
+  public:
+
+    RGBLED_TraceBuffer() : RGBLED_Trace(_storage, N) {}
+
+  private:
+
+    uint8_t _storage[N][3];      ///< Ring entries.
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+/**
+ * @file RGBLED_TraceReplay.h
+ * @brief Replay of recorded output traces against the expected @ref RGBLED::blink schedule.
+ * @details
+ *  - Input is a list of @ref RGBLED_TraceEvent (absolute time, pin, value), e.g. read back
+ *    from an @ref RGBLED_Trace or parsed from its CSV dump on a PC.
+ *  - The reference schedule is derived from the documented blink semantics, independent of
+ *    the library's timer code:
+ *    - Finite and blocking: @c 2*number intervals share @c duration_ms; the first
+ *      @c duration_ms % (2*number) intervals are 1 ms longer. The LED starts ON and toggles
+ *      at each interval boundary; the last interval is the final OFF phase.
+ *    - Infinite: toggles every @c duration_ms (half-period).
+ *  - The replay pairs the k-th level change of the pin with the k-th scheduled edge and
+ *    reports timing error, missing and extra edges, and redundant writes (elided events, or
+ *    writes repeating the pin's previous value).
+ *  - Depends only on @c <stdint.h>, so the same code runs in a desktop test harness.
+ *
+ * @version 1.0
+ * @author Mohammad
+ */
+
+// ########################################################################################
+// Include libraries:
+
+#include <stdint.h>
+
+// ###########################################################################
+// Structures
+// ###########################################################################
+
+/**
+ * @struct RGBLED_TraceEvent
+ * @brief One recorded hardware write.
+ */
+struct RGBLED_TraceEvent
+{
+  uint32_t t;      ///< Time of the write in @c millis() units.
+  uint8_t  pin;    ///< Pin number written.
+  uint8_t  value;  ///< PWM duty, or HIGH/LOW on the digital path.
+  bool     elided; ///< Requested write skipped because the pin already held @c value.
+};
+
+/**
+ * @enum RGBLED_BlinkMode
+ * @brief Blink variant to replay against.
+ */
+enum RGBLED_BlinkMode : uint8_t
+{
+  RGBLED_BLINK_FINITE   = 0,  /**< blink(duration_ms, number, false), number > 0. */
+  RGBLED_BLINK_INFINITE = 1,  /**< blink(halfPeriod_ms, 0). */
+  RGBLED_BLINK_BLOCKING = 2   /**< blink(duration_ms, number, true). */
+};
+
+/**
+ * @struct RGBLED_BlinkReport
+ * @brief Result of @ref RGBLED_replayBlink. Errors are actual minus expected time in ms.
+ */
+struct RGBLED_BlinkReport
+{
+  uint16_t expectedEdges = 0;    ///< Scheduled edges up to the end of the trace.
+  uint16_t matchedEdges = 0;     ///< Level changes paired with a scheduled edge.
+  uint16_t missingEdges = 0;     ///< Scheduled edges with no level change.
+  uint16_t extraEdges = 0;       ///< Level changes beyond the schedule or of the wrong polarity.
+  uint16_t redundantWrites = 0;  ///< Elided writes and writes repeating the pin's previous value.
+  int32_t  minError = 0;         ///< Earliest edge (negative = early).
+  int32_t  maxError = 0;         ///< Latest edge.
+  uint32_t sumAbsError = 0;      ///< Sum of |error| over matched edges.
+
+  /** @brief True if every scheduled edge matched within @p tolerance_ms and nothing extra. */
+  bool ok(uint16_t tolerance_ms) const
+  {
+    return missingEdges == 0 && extraEdges == 0 &&
+           minError >= -(int32_t)tolerance_ms && maxError <= (int32_t)tolerance_ms;
+  }
+};
+
+// ###########################################################################
+// Replay
+// ###########################################################################
+
+/**
+ * @brief Time of scheduled edge @p k relative to the blink start.
+ * @param mode        Blink variant.
+ * @param duration_ms Total duration (finite/blocking) or half-period (infinite).
+ * @param number      Number of ON/OFF cycles (finite/blocking).
+ * @param k           Edge index; even edges turn ON, odd edges turn OFF.
+ */
+static inline uint32_t RGBLED_blinkEdgeTime(RGBLED_BlinkMode mode, uint16_t duration_ms, uint32_t number, uint32_t k)
+{
+  if (mode == RGBLED_BLINK_INFINITE) return k * duration_ms;
+
+  const uint32_t intervals = 2UL * number;
+  uint32_t base = duration_ms / intervals;
+  const uint32_t rem = duration_ms % intervals;
+  if (base == 0) base = 1;  // the library never schedules a zero-length interval
+  return k * base + (k < rem ? k : rem);
+}
+
+/**
+ * @brief Compare the writes to one pin against the blink schedule.
+ * @param ev          Trace events, oldest first (other pins are ignored).
+ * @param n           Number of events.
+ * @param pin         Pin to check (any one channel of the LED).
+ * @param offValue    Value the pin holds while the LED is dark (LOW/0 for active-high
+ *                    wiring, HIGH/255 for active-low).
+ * @param mode        Blink variant.
+ * @param duration_ms Total duration (finite/blocking) or half-period (infinite).
+ * @param number      Number of ON/OFF cycles (ignored for infinite).
+ * @param t0          Blink start in @c millis() units; the first ON write of the pin is used
+ *                    when @p t0 is 0.
+ * @return Report; schedule edges after the last event are not counted as missing.
+ */
+static inline RGBLED_BlinkReport RGBLED_replayBlink(const RGBLED_TraceEvent* ev, uint16_t n, uint8_t pin,
+                                                    uint8_t offValue, RGBLED_BlinkMode mode,
+                                                    uint16_t duration_ms, uint32_t number, uint32_t t0 = 0)
+{
+  RGBLED_BlinkReport rep;
+  if (n == 0 || duration_ms == 0 || (mode != RGBLED_BLINK_INFINITE && number == 0)) return rep;
+
+  const uint32_t edgesTotal = (mode == RGBLED_BLINK_INFINITE) ? 0xFFFFFFFFUL : 2UL * number;
+  bool     havePrev = false, lit = false;
+  uint8_t  prev = 0;
+  uint32_t k = 0;        // next scheduled edge
+  bool     started = (t0 != 0);
+
+  for (uint16_t i = 0; i < n; ++i)
+  {
+    if (ev[i].pin != pin) continue;
+
+    if (ev[i].elided) { ++rep.redundantWrites; continue; }
+    if (havePrev && ev[i].value == prev) { ++rep.redundantWrites; continue; }
+    havePrev = true;
+    prev = ev[i].value;
+
+    const bool nowLit = (ev[i].value != offValue);
+    if (nowLit == lit) continue;  // duty change without an ON/OFF transition
+    lit = nowLit;
+
+    if (!started) { if (!nowLit) continue; t0 = ev[i].t; started = true; }
+    if ((int32_t)(ev[i].t - t0) < 0) continue;  // before the blink started
+
+    // Already lit at t0: the start edge wrote nothing (elided), so it holds by definition.
+    if (k == 0 && !nowLit) { k = 1; ++rep.matchedEdges; }
+
+    if (k >= edgesTotal || nowLit != ((k & 1) == 0)) { ++rep.extraEdges; continue; }
+
+    const int32_t err = (int32_t)(ev[i].t - (t0 + RGBLED_blinkEdgeTime(mode, duration_ms, number, k)));
+    if (rep.matchedEdges == 0 || err < rep.minError) rep.minError = err;
+    if (rep.matchedEdges == 0 || err > rep.maxError) rep.maxError = err;
+    rep.sumAbsError += (uint32_t)(err < 0 ? -err : err);
+    ++rep.matchedEdges;
+    ++k;
+  }
+
+  // Edges due before the end of the trace.
+  if (started)
+  {
+    const uint32_t tEnd = ev[n - 1].t;
+    uint32_t due = 0;
+    while (due < edgesTotal && (int32_t)(t0 + RGBLED_blinkEdgeTime(mode, duration_ms, number, due) - tEnd) <= 0) ++due;
+    rep.expectedEdges = (uint16_t)(due > 0xFFFF ? 0xFFFF : due);
+    if (due > k) rep.missingEdges = (uint16_t)(due - k > 0xFFFF ? 0xFFFF : due - k);
+  }
+  return rep;
+}
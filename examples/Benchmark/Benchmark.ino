@@ -0,0 +1,207 @@
+/**
+ * @file Benchmark.ino
+ * @brief Micro-benchmark of the RGBLED hot paths (digital and PWM modes).
+ *
+ * Wiring:
+ *   - RED   -> pin 9
+ *   - GREEN -> pin 10
+ *   - BLUE  -> pin 11
+ *
+ * Nothing needs to be connected for the timings to be valid; the LED only flickers.
+ *
+ * Output (Serial @ 115200), one line per method and mode:
+ *   <mode> <method>  ns/op=<nanoseconds per call>  calls/s=<calls per second>  elided=<skipped writes>
+ *
+ * Notes:
+ *   - Each method is called BENCH_ITERATIONS times back-to-back and timed with micros().
+ *   - The cost of the empty timing loop is measured once and subtracted from every result.
+ *   - Run the sketch before and after a change to RGBLED.cpp and diff the two logs.
+ *   - Prints the skipped pin writes of each run; build with -DRGBLED_ENABLE_STATS=1 to also
+ *     print real pin writes per call.
+ *   - The effect lines also print CPU cycles per call and check them against
+ *     EFFECT_CYCLE_BUDGET (evaluation only, without the pin writes). Full effect frames are
+ *     measured only with -DRGBLED_ENABLE_EFFECTS=1.
+ */
+
+#include "RGBLED.h"
+
+constexpr int PIN_R = 9;
+constexpr int PIN_G = 10;
+constexpr int PIN_B = 11;
+
+constexpr uint16_t BENCH_ITERATIONS = 2000;
+constexpr uint32_t EFFECT_CYCLE_BUDGET = 400;   // per effect frame evaluation on AVR
+
+RGBLED led;
+
+volatile uint8_t sink = 0;       // keeps the baseline loop from being optimized away
+uint32_t loopOverheadUs = 0;     // cost of BENCH_ITERATIONS empty iterations
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+typedef void (*BenchFn)(uint16_t i);
+
+uint32_t timeLoop(BenchFn fn) {
+  const uint32_t t0 = micros();
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; ++i) {
+    fn(i);
+  }
+  return micros() - t0;
+}
+
+uint32_t report(const __FlashStringHelper* mode, const __FlashStringHelper* name, BenchFn fn) {
+#if RGBLED_ENABLE_STATS
+  led.resetStats();
+#else
+  led.resetElidedWrites();
+#endif
+  uint32_t us = timeLoop(fn);
+  const uint32_t elided = led.elidedWrites();
+  us = (us > loopOverheadUs) ? (us - loopOverheadUs) : 0;
+
+  const uint32_t nsPerOp = (us * 1000UL) / BENCH_ITERATIONS;
+  const uint32_t callsPerSec = nsPerOp ? (1000000000UL / nsPerOp) : 0;
+
+  Serial.print(mode);
+  Serial.print(' ');
+  Serial.print(name);
+  Serial.print(F("  ns/op="));
+  Serial.print(nsPerOp);
+  Serial.print(F("  calls/s="));
+  Serial.print(callsPerSec);
+  Serial.print(F("  elided="));
+  Serial.print(elided);
+#if RGBLED_ENABLE_STATS
+  RGBLED_Stats st;
+  led.getStats(st);
+  // Pin writes per call, x100 (fixed point)
+  Serial.print(F("  writes/call x100="));
+  Serial.println(st.pinWrites * 100UL / BENCH_ITERATIONS);
+#else
+  Serial.println();
+#endif
+  return nsPerOp;
+}
+
+void reportCycles(const __FlashStringHelper* name, BenchFn fn) {
+  const uint32_t ns = report(F("[effect] "), name, fn);
+  const uint32_t cycles = ns * (F_CPU / 1000000UL) / 1000UL;
+  Serial.print(F("           cycles/op="));
+  Serial.print(cycles);
+  Serial.print(F("  budget="));
+  Serial.print(EFFECT_CYCLE_BUDGET);
+  Serial.println(cycles <= EFFECT_CYCLE_BUDGET ? F("  OK") : F("  OVER"));
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarked operations
+// -----------------------------------------------------------------------------
+
+void opEmpty(uint16_t i)       { sink = (uint8_t)i; }
+void opSetSame(uint16_t)       { led.set(true, false, true); }
+void opSetAlternate(uint16_t i){ led.set(i & 1, false, true); }
+void opSetRGBSame(uint16_t)    { led.setRGB(200, 40, 90); }
+void opSetRGBRamp(uint16_t i)  { led.setRGB((uint8_t)i, (uint8_t)(i >> 1), (uint8_t)(255 - i)); }
+void opOn(uint16_t)            { led.on(); }
+void opOff(uint16_t)           { led.off(); }
+void opToggle(uint16_t)        { led.toggle(); }
+void opInverse(uint16_t)       { led.inverse(); }
+void opPreset(uint16_t)        { led.cyan(); }
+void opBlinkUpdate(uint16_t)   { led.blinkUpdate(); }
+void opUpdateAt(uint16_t i)    { led.update((uint32_t)i * 7); }
+
+// Effect evaluation without output: phase, waveform and colour scaling / HSV.
+const uint32_t effRate = RGBLED_phaseRate(1500);
+void opBreatheEval(uint16_t i) {
+  const uint8_t l = RGBLED_breathe8(RGBLED_phase8((uint32_t)i * 7, effRate));
+  sink = (uint8_t)(RGBLED_scale8(200, l) ^ RGBLED_scale8(40, l) ^ RGBLED_scale8(90, l));
+}
+void opHeartbeatEval(uint16_t i) {
+  const uint8_t l = RGBLED_heartbeat8(RGBLED_phase8((uint32_t)i * 7, effRate));
+  sink = (uint8_t)(RGBLED_scale8(200, l) ^ RGBLED_scale8(40, l) ^ RGBLED_scale8(90, l));
+}
+void opRainbowEval(uint16_t i) {
+  uint8_t r, g, b;
+  RGBLED_hsvToRgb(RGBLED_phase8((uint32_t)i * 7, effRate), 255, 255, r, g, b);
+  sink = (uint8_t)(r ^ g ^ b);
+}
+
+void runSuite(const __FlashStringHelper* mode) {
+  report(mode, F("set(same)      "), opSetSame);
+  report(mode, F("set(alternate) "), opSetAlternate);
+  report(mode, F("setRGB(same)   "), opSetRGBSame);
+  report(mode, F("setRGB(ramp)   "), opSetRGBRamp);
+  report(mode, F("on()           "), opOn);
+  report(mode, F("off()          "), opOff);
+  report(mode, F("toggle()       "), opToggle);
+  report(mode, F("inverse()      "), opInverse);
+  report(mode, F("cyan()         "), opPreset);
+
+  led.stopBlink(true);
+  report(mode, F("blinkUpdate(idle)"), opBlinkUpdate);
+
+  // Infinite blink with a long half-period: almost every call takes the early-return path.
+  led.white();
+  led.blink(60000, 0, false);
+  report(mode, F("blinkUpdate(wait)"), opBlinkUpdate);
+
+  // 1 ms half-period: a large share of calls fire an edge.
+  led.blink(1, 0, false);
+  report(mode, F("blinkUpdate(edge)"), opBlinkUpdate);
+  led.stopBlink(true);
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { /* wait for native USB boards */ }
+
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+
+  if (!led.init()) {
+    Serial.print(F("Init failed: "));
+    Serial.println(RGBLED::errorText(led.lastError));
+    while (true) { delay(1000); }
+  }
+
+  loopOverheadUs = timeLoop(opEmpty);
+
+  Serial.print(F("RGBLED benchmark, iterations="));
+  Serial.print(BENCH_ITERATIONS);
+  Serial.print(F(", loop overhead us="));
+  Serial.println(loopOverheadUs);
+
+  led.enablePWM(false);
+  runSuite(F("[digital]"));
+
+  led.enablePWM(true);
+  led.setBrightness(200);
+  runSuite(F("[pwm]    "));
+
+  // Effects: evaluation cost against the budget, then full frames including PWM writes.
+  reportCycles(F("breathe eval   "), opBreatheEval);
+  reportCycles(F("heartbeat eval "), opHeartbeatEval);
+  reportCycles(F("rainbow eval   "), opRainbowEval);
+#if RGBLED_ENABLE_EFFECTS
+  led.setRGB(200, 40, 90);
+  led.breathe(1500);
+  report(F("[effect] "), F("breathe frame  "), opUpdateAt);
+  led.rainbow(1500);
+  report(F("[effect] "), F("rainbow frame  "), opUpdateAt);
+  led.stopEffect();
+#endif
+
+  led.off();
+  Serial.println(F("Done."));
+}
+
+void loop() {
+}
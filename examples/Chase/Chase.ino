@@ -0,0 +1,66 @@
+/**
+ * @file Chase.ino
+ * @brief Three LEDs chasing on one shared clock (RGBLED_Timebase).
+ *
+ * Wiring (common cathode, digital pins):
+ *   - LED A: R/G/B -> pins 2/3/4
+ *   - LED B: R/G/B -> pins 5/6/7
+ *   - LED C: R/G/B -> pins 8/12/13
+ *
+ * Notes:
+ *   - Each LED is ON for a third of the 900 ms period, one third after the previous one.
+ *   - Send 'a' on the serial monitor to switch A and C into an alternating pair (B dark),
+ *     'c' to return to the chase. The clock is never restarted, so the phase is kept.
+ *   - Edges come from one origin; the pattern does not drift apart however long it runs.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Timebase.h"
+
+constexpr uint16_t PERIOD_MS = 900;
+constexpr uint16_t SLOT_MS   = PERIOD_MS / 3;
+
+RGBLED ledA, ledB, ledC;
+RGBLED_Timebase<3> chase(PERIOD_MS);
+
+static bool setupLed(RGBLED& led, uint8_t r, uint8_t g, uint8_t b) {
+  led.parameters.RED_PIN     = r;
+  led.parameters.GREEN_PIN   = g;
+  led.parameters.BLUE_PIN    = b;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  return led.init();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!setupLed(ledA, 2, 3, 4) || !setupLed(ledB, 5, 6, 7) || !setupLed(ledC, 8, 12, 13)) {
+    Serial.println(F("Init failed"));
+    while (true) { delay(1000); }
+  }
+  ledA.set(1, 0, 0);
+  ledB.set(0, 1, 0);
+  ledC.set(0, 0, 1);
+
+  chase.join(ledA, 0 * SLOT_MS, SLOT_MS);
+  chase.join(ledB, 1 * SLOT_MS, SLOT_MS);
+  chase.join(ledC, 2 * SLOT_MS, SLOT_MS);
+  chase.start();
+}
+
+void loop() {
+  if (Serial.available()) {
+    const char c = Serial.read();
+    if (c == 'a') {
+      chase.setPhase(0, 0, PERIOD_MS / 2);
+      chase.setPhase(1, 0, 0);               // always OFF
+      chase.setPhase(2, PERIOD_MS / 2, PERIOD_MS / 2);
+      Serial.println(F("[CHASE] alternating"));
+    } else if (c == 'c') {
+      for (uint8_t i = 0; i < 3; ++i) chase.setPhase(i, i * SLOT_MS, SLOT_MS);
+      Serial.println(F("[CHASE] chase"));
+    }
+  }
+
+  chase.update();
+}
@@ -0,0 +1,149 @@
+/**
+ * @file ColorConversion.ino
+ * @brief Accuracy and speed of the integer HSV / colour-temperature conversions vs float.
+ *
+ * Nothing needs to be connected; results are printed on Serial @ 115200.
+ *
+ * Output:
+ *   [accuracy] <conversion>  max error=<counts>  (against the float reference, per channel)
+ *   [speed]    <conversion>  ns/op=<nanoseconds per call>
+ *
+ * Notes:
+ *   - The float references are the textbook HSV formula and Tanner Helland's black-body fit;
+ *     the integer versions are expected within a few counts of them.
+ *   - A hue sweep over many LEDs costs one conversion per LED and frame, so ns/op is the
+ *     number that matters for large groups.
+ */
+
+#include "RGBLED.h"
+
+constexpr uint16_t BENCH_ITERATIONS = 2000;
+
+volatile uint8_t sink = 0;   // keeps the timed loops from being optimized away
+
+// -----------------------------------------------------------------------------
+// Float references
+// -----------------------------------------------------------------------------
+
+void hsvFloat(float hDeg, float s, float v, float &r, float &g, float &b) {
+  const float c = v * s;
+  const float hp = hDeg / 60.0f;
+  const float x = c * (1.0f - fabs(fmod(hp, 2.0f) - 1.0f));
+  float r1 = 0, g1 = 0, b1 = 0;
+  if      (hp < 1) { r1 = c; g1 = x; }
+  else if (hp < 2) { r1 = x; g1 = c; }
+  else if (hp < 3) { g1 = c; b1 = x; }
+  else if (hp < 4) { g1 = x; b1 = c; }
+  else if (hp < 5) { r1 = x; b1 = c; }
+  else             { r1 = c; b1 = x; }
+  const float m = v - c;
+  r = (r1 + m) * 255.0f; g = (g1 + m) * 255.0f; b = (b1 + m) * 255.0f;
+}
+
+float clamp255(float x) { return x < 0 ? 0 : (x > 255 ? 255 : x); }
+
+void kelvinFloat(uint16_t k, float &r, float &g, float &b) {
+  const float t = k / 100.0f;
+  r = (t <= 66) ? 255 : clamp255(329.698727446f * pow(t - 60, -0.1332047592f));
+  g = (t <= 66) ? clamp255(99.4708025861f * log(t) - 161.1195681661f)
+                : clamp255(288.1221695283f * pow(t - 60, -0.0755148492f));
+  b = (t >= 66) ? 255 : ((t <= 19) ? 0 : clamp255(138.5177312231f * log(t - 10) - 305.0447927307f));
+}
+
+// Largest per-channel difference, rounded, folded into `worst`.
+void trackErr(uint8_t &worst, uint8_t r, uint8_t g, uint8_t b, float fr, float fg, float fb) {
+  float e = fabs(r - fr);
+  if (fabs(g - fg) > e) e = fabs(g - fg);
+  if (fabs(b - fb) > e) e = fabs(b - fb);
+  const uint8_t c = (uint8_t)(e + 0.5f);
+  if (c > worst) worst = c;
+}
+
+// -----------------------------------------------------------------------------
+// Accuracy
+// -----------------------------------------------------------------------------
+
+void accuracy() {
+  uint8_t r, g, b;
+  float fr, fg, fb;
+
+  uint8_t worst = 0;
+  for (uint16_t h = 0; h < 256; ++h)
+    for (uint16_t s = 0; s < 256; s += 17)
+      for (uint16_t v = 0; v < 256; v += 17) {
+        RGBLED_hsvToRgb(h, s, v, r, g, b);
+        hsvFloat(h * 360.0f / 256.0f, s / 255.0f, v / 255.0f, fr, fg, fb);
+        trackErr(worst, r, g, b, fr, fg, fb);
+      }
+  Serial.print(F("[accuracy] hsv8     max error="));
+  Serial.println(worst);
+
+  worst = 0;
+  for (uint32_t h = 0; h < 65536; h += 97) {
+    RGBLED_hsv16ToRgb(h, 255, 255, r, g, b);
+    hsvFloat(h * 360.0f / 65536.0f, 1.0f, 1.0f, fr, fg, fb);
+    trackErr(worst, r, g, b, fr, fg, fb);
+  }
+  Serial.print(F("[accuracy] hsv16    max error="));
+  Serial.println(worst);
+
+  worst = 0;
+  for (uint16_t k = RGBLED_KELVIN_MIN; k <= RGBLED_KELVIN_MAX; k += 7) {
+    RGBLED_kelvinToRgb(k, r, g, b);
+    kelvinFloat(k, fr, fg, fb);
+    trackErr(worst, r, g, b, fr, fg, fb);
+  }
+  Serial.print(F("[accuracy] kelvin   max error="));
+  Serial.println(worst);
+}
+
+// -----------------------------------------------------------------------------
+// Speed
+// -----------------------------------------------------------------------------
+
+typedef void (*BenchFn)(uint16_t i);
+
+void opEmpty(uint16_t i)      { sink = (uint8_t)i; }
+void opHsv8(uint16_t i)       { uint8_t r, g, b; RGBLED_hsvToRgb((uint8_t)i, 255, 200, r, g, b); sink = r ^ g ^ b; }
+void opHsv16(uint16_t i)      { uint8_t r, g, b; RGBLED_hsv16ToRgb(i * 31, 255, 200, r, g, b); sink = r ^ g ^ b; }
+void opKelvin(uint16_t i)     { uint8_t r, g, b; RGBLED_kelvinToRgb(1000 + i * 5, r, g, b); sink = r ^ g ^ b; }
+void opHsvFloat(uint16_t i)   { float r, g, b; hsvFloat((uint8_t)i * 1.40625f, 1.0f, 0.784f, r, g, b); sink = (uint8_t)(r + g + b); }
+void opKelvinFloat(uint16_t i){ float r, g, b; kelvinFloat(1000 + i * 5, r, g, b); sink = (uint8_t)(r + g + b); }
+
+uint32_t timeLoop(BenchFn fn) {
+  const uint32_t t0 = micros();
+  for (uint16_t i = 0; i < BENCH_ITERATIONS; ++i) fn(i);
+  return micros() - t0;
+}
+
+void report(const __FlashStringHelper* name, BenchFn fn, uint32_t overheadUs) {
+  uint32_t us = timeLoop(fn);
+  us = (us > overheadUs) ? (us - overheadUs) : 0;
+  Serial.print(F("[speed]    "));
+  Serial.print(name);
+  Serial.print(F("  ns/op="));
+  Serial.println(us * 1000UL / BENCH_ITERATIONS);
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { /* wait for native USB boards */ }
+
+  accuracy();
+
+  const uint32_t overheadUs = timeLoop(opEmpty);
+  report(F("hsv8         "), opHsv8, overheadUs);
+  report(F("hsv16        "), opHsv16, overheadUs);
+  report(F("kelvin       "), opKelvin, overheadUs);
+  report(F("hsv (float)  "), opHsvFloat, overheadUs);
+  report(F("kelvin(float)"), opKelvinFloat, overheadUs);
+
+  Serial.println(F("Done."));
+}
+
+void loop() {
+}
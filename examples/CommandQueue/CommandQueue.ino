@@ -0,0 +1,94 @@
+/**
+ * @file CommandQueue.ino
+ * @brief Changing LED colours from an interrupt through the lock-free command queue.
+ *
+ * Wiring:
+ *   - RED   -> pin 9
+ *   - GREEN -> pin 10
+ *   - BLUE  -> pin 11
+ *   - Push button between pin 2 and GND (internal pull-up)
+ *
+ * Notes:
+ *   - The button ISR only posts commands; the pins are written by loop() in drain().
+ *   - Bouncing produces bursts of colour commands; drain() applies only the last one.
+ *   - Every 2 s the sketch prints the queue statistics and the measured post + pop cost.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_CommandQueue.h"
+
+constexpr int PIN_R = 9;
+constexpr int PIN_G = 10;
+constexpr int PIN_B = 11;
+constexpr int PIN_BUTTON = 2;
+
+RGBLED led;
+RGBLED_CommandQueue<16> queue;
+
+// -----------------------------------------------------------------------------
+// Producer (interrupt context)
+// -----------------------------------------------------------------------------
+
+void onButton() {
+  static uint8_t idx = 0;
+  static const uint8_t COLORS[][3] = {
+    {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 180, 0}, {0, 0, 0}
+  };
+  idx = (uint8_t)((idx + 1) % 5);
+  queue.postRGB(0, COLORS[idx][0], COLORS[idx][1], COLORS[idx][2]);
+}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+void printStats() {
+  static uint32_t tLast = 0;
+  const uint32_t now = millis();
+  if (now - tLast < 2000) return;
+  tLast = now;
+
+  // Cost of one post and one pop, on a separate queue so the LED is not touched.
+  static RGBLED_CommandQueue<8> probe;
+  RGBLED_Command cmd;
+  const uint32_t t0 = micros();
+  for (uint8_t i = 0; i < 8; ++i) probe.postRGB(0, i, 0, 0);
+  while (probe.pop(cmd)) {}
+  const uint32_t ns = (micros() - t0) * 1000UL / 8;
+
+  Serial.print(F("[QUEUE] coalesced="));
+  Serial.print(queue.coalesced());
+  Serial.print(F("  dropped="));
+  Serial.print(queue.dropped());
+  Serial.print(F("  post+pop ns="));
+  Serial.println(ns);
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+
+  if (!led.init()) {
+    Serial.print(F("Init failed: "));
+    Serial.println(RGBLED::errorText(led.lastError));
+    while (true) { delay(1000); }
+  }
+  led.enablePWM(true);
+
+  pinMode(PIN_BUTTON, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(PIN_BUTTON), onButton, FALLING);
+}
+
+void loop() {
+  queue.drain(led);   // apply what the ISR posted
+  led.update();
+  printStats();
+}
@@ -0,0 +1,78 @@
+/**
+ * @file Layers.ino
+ * @brief Base colour with notification and fault overlays (RGBLED_Compositor).
+ *
+ * Wiring:
+ *   - RED   -> pin 9
+ *   - GREEN -> pin 10
+ *   - BLUE  -> pin 11
+ *   - Push button between pin 2 and GND (internal pull-up)
+ *
+ * Notes:
+ *   - Layer 0 (base): slow blue breathe.
+ *   - Layer 1 (notification): green strobe for 3 s after each button press.
+ *   - Layer 2 (fault): half-transparent red heartbeat, toggled with 'f' on the serial monitor.
+ *   - Hiding an overlay restores the layers below it; the base breathe never restarts.
+ *   - Every 2 s the sketch prints how many compositions ran (0 growth while nothing animates).
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Compositor.h"
+
+constexpr int PIN_R = 9;
+constexpr int PIN_G = 10;
+constexpr int PIN_B = 11;
+constexpr int PIN_BUTTON = 2;
+
+enum { BASE = 0, NOTIFY = 1, FAULT = 2 };
+
+RGBLED led;
+RGBLED_Compositor<3> layers(led);
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(PIN_BUTTON, INPUT_PULLUP);
+
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  if (!led.init()) {
+    Serial.println(F("Init failed"));
+    while (true) { delay(1000); }
+  }
+  led.enablePWM(true);
+
+  layers.setColor(BASE, 0, 40, 255);
+  layers.setEffect(BASE, RGBLED_EFFECT_BREATHE, 4000);
+  layers.show(BASE);
+
+  layers.setColor(NOTIFY, 0, 255, 0);
+  layers.setEffect(NOTIFY, RGBLED_EFFECT_STROBE, 250, 128);
+
+  layers.setColor(FAULT, 255, 0, 0);
+  layers.setAlpha(FAULT, 160);
+  layers.setEffect(FAULT, RGBLED_EFFECT_HEARTBEAT, 1000);
+}
+
+void loop() {
+  static bool lastButton = HIGH;
+  const bool button = digitalRead(PIN_BUTTON);
+  if (lastButton == HIGH && button == LOW) layers.show(NOTIFY, 3000);
+  lastButton = button;
+
+  if (Serial.available() && Serial.read() == 'f') {
+    if (layers.isVisible(FAULT)) layers.hide(FAULT);
+    else                         layers.show(FAULT);
+  }
+
+  layers.update();
+  led.update();
+
+  static uint32_t tLast = 0;
+  if (millis() - tLast >= 2000) {
+    tLast = millis();
+    Serial.print(F("[LAYERS] compositions="));
+    Serial.println(layers.compositions());
+  }
+}
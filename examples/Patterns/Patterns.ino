@@ -0,0 +1,110 @@
+/**
+ * @file Patterns.ino
+ * @brief Flash-stored light patterns played by the non-blocking RGBLED sequencer.
+ *
+ * Wiring:
+ *   - RED   -> pin 9
+ *   - GREEN -> pin 10
+ *   - BLUE  -> pin 11
+ *
+ * Notes:
+ *   - Patterns live in PROGMEM and are checked at compile time with RGBLED_patternValid.
+ *   - Each running pattern costs a few bytes of RAM, regardless of its length.
+ *   - Call led.update() (or led.blinkUpdate()) regularly in loop().
+ *   - Build with -DRGBLED_ENABLE_PATTERNS=1 -DRGBLED_ENABLE_FADE=1 (RGBLED.cpp must see the
+ *     flags too). Without fades, FADE steps switch to their color at once.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Pattern.h"
+
+#if !RGBLED_ENABLE_PATTERNS
+  #error "Build this example with -DRGBLED_ENABLE_PATTERNS=1"
+#endif
+
+constexpr int PIN_R = 9;
+constexpr int PIN_G = 10;
+constexpr int PIN_B = 11;
+
+RGBLED led;
+
+// -----------------------------------------------------------------------------
+// Patterns
+// -----------------------------------------------------------------------------
+
+// SOS in white: ... --- ... then 2 s pause, forever.
+static constexpr uint8_t SOS[] PROGMEM = {
+  /*  0 */ RGBLED_P_COLOR(255, 255, 255), RGBLED_P_HOLD(150), RGBLED_P_OFF(), RGBLED_P_HOLD(150),
+  /* 11 */ RGBLED_P_REPEAT(3, 0),
+  /* 14 */ RGBLED_P_HOLD(300),
+  /* 17 */ RGBLED_P_COLOR(255, 255, 255), RGBLED_P_HOLD(450), RGBLED_P_OFF(), RGBLED_P_HOLD(150),
+  /* 28 */ RGBLED_P_REPEAT(3, 17),
+  /* 31 */ RGBLED_P_HOLD(300),
+  /* 34 */ RGBLED_P_COLOR(255, 255, 255), RGBLED_P_HOLD(150), RGBLED_P_OFF(), RGBLED_P_HOLD(150),
+  /* 45 */ RGBLED_P_REPEAT(3, 34),
+  /* 48 */ RGBLED_P_HOLD(2000),
+  /* 51 */ RGBLED_P_JUMP(0)
+};
+static_assert(RGBLED_patternValid(SOS, sizeof(SOS)), "SOS pattern is malformed");
+
+// Red double-blink, played 3 times, then stop.
+static constexpr uint8_t DOUBLE_RED[] PROGMEM = {
+  /*  0 */ RGBLED_P_COLOR(255, 0, 0), RGBLED_P_HOLD(100), RGBLED_P_OFF(), RGBLED_P_HOLD(100),
+  /* 11 */ RGBLED_P_COLOR(255, 0, 0), RGBLED_P_HOLD(100), RGBLED_P_OFF(), RGBLED_P_HOLD(700),
+  /* 22 */ RGBLED_P_REPEAT(3, 0),
+  /* 25 */ RGBLED_P_END()
+};
+static_assert(RGBLED_patternValid(DOUBLE_RED, sizeof(DOUBLE_RED)), "DOUBLE_RED pattern is malformed");
+
+// Smooth red -> green -> blue cycle, 3 rounds, then stop (PWM pins required).
+static constexpr uint8_t COLOR_CYCLE[] PROGMEM = {
+  /*  0 */ RGBLED_P_FADE(255, 0, 0, 1000),
+  /*  6 */ RGBLED_P_FADE(0, 255, 0, 1000),
+  /* 12 */ RGBLED_P_FADE(0, 0, 255, 1000),
+  /* 18 */ RGBLED_P_REPEAT(3, 0),
+  /* 21 */ RGBLED_P_END()
+};
+static_assert(RGBLED_patternValid(COLOR_CYCLE, sizeof(COLOR_CYCLE)), "COLOR_CYCLE pattern is malformed");
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+
+  if (!led.init()) {
+    Serial.print(F("Init failed: "));
+    Serial.println(RGBLED::errorText(led.lastError));
+    while (true) { delay(1000); }
+  }
+
+  Serial.println(F("[PATTERN] double red x3"));
+  led.playPattern(DOUBLE_RED);
+}
+
+void loop() {
+  static uint8_t next = 0;
+
+  led.update();
+
+  if (led.isPlaying()) return;
+
+  switch (next++) {
+    case 0:
+      Serial.println(F("[PATTERN] color cycle x3"));
+      led.enablePWM(true);
+      led.playPattern(COLOR_CYCLE);
+      break;
+    default:
+      Serial.println(F("[PATTERN] SOS"));
+      led.enablePWM(false);
+      led.playPattern(SOS);
+      break;
+  }
+}
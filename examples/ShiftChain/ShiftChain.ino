@@ -0,0 +1,100 @@
+/**
+ * @file ShiftChain.ino
+ * @brief 16 dimmable RGB LEDs on six daisy-chained 74HC595 shift registers (AVR, Timer2 BAM).
+ *
+ * Wiring (Arduino Uno / Nano):
+ *   - MOSI (11) -> SER of the first register, QH' -> SER of the next one
+ *   - SCK  (13) -> SRCLK of all registers
+ *   - pin 10    -> RCLK (latch) of all registers
+ *   - OE tied LOW, SRCLR tied HIGH; LED k uses outputs 3k, 3k+1, 3k+2 (R, G, B)
+ *
+ * Notes:
+ *   - 6-bit BAM: a frame is 63 ticks. Timer2 in CTC mode with prescaler 1024 gives 64 us per
+ *     tick, so a frame lasts ~4 ms (~248 Hz). One plane (6 bytes) must fit into one tick.
+ *   - The ISR owns the SPI bus; do not use other SPI devices from the sketch.
+ *   - Every 2 s the sketch prints the refresh rate, bytes per second and the time of one plane.
+ */
+
+#include <SPI.h>
+#include "RGBLED_ShiftChain.h"
+
+constexpr uint16_t NUM_LEDS = 16;
+
+RGBLED_ShiftChain<NUM_LEDS, RGBLED_ShiftSPI<10>, 6> chain;
+
+// -----------------------------------------------------------------------------
+// Timer2 BAM driver
+// -----------------------------------------------------------------------------
+
+ISR(TIMER2_COMPA_vect) {
+  OCR2A = chain.tick() - 1;   // next interrupt after 1, 2, 4, ... 32 ticks
+}
+
+void startTimer2() {
+  noInterrupts();
+  TCCR2A = _BV(WGM21);                          // CTC
+  TCCR2B = _BV(CS22) | _BV(CS21) | _BV(CS20);   // clk/1024 -> 64 us per tick
+  TCNT2  = 0;
+  OCR2A  = 0;
+  TIMSK2 = _BV(OCIE2A);
+  interrupts();
+}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+void printStats() {
+  static uint32_t tLast = 0;
+  const uint32_t now = millis();
+  if (now - tLast < 2000) return;
+
+  const uint32_t frames = chain.frames();
+  const uint32_t bytes  = chain.bytesSent();
+  chain.resetStats();
+  const uint32_t elapsed = now - tLast;
+  tLast = now;
+
+  // Plane cost: time a batch of ticks with the timer interrupt masked.
+  TIMSK2 = 0;
+  const uint32_t t0 = micros();
+  for (uint8_t i = 0; i < 12; ++i) chain.tick();
+  const uint32_t planeUs = (micros() - t0) / 12;
+  TIMSK2 = _BV(OCIE2A);
+
+  Serial.print(F("[SHIFT] refresh Hz="));
+  Serial.print(frames * 1000UL / elapsed);
+  Serial.print(F("  bytes/s="));
+  Serial.print(bytes * 1000UL / elapsed);
+  Serial.print(F("  bytes/plane="));
+  Serial.print(chain.BYTES);
+  Serial.print(F("  plane us="));
+  Serial.println(planeUs);
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+  chain.begin();
+  startTimer2();
+}
+
+void loop() {
+  // Slow colour wheel across the chain; only changed bits are touched in the frame buffer.
+  static uint8_t phase = 0;
+  static uint32_t tNext = 0;
+  if ((int32_t)(millis() - tNext) >= 0) {
+    tNext += 20;
+    ++phase;
+    for (uint16_t i = 0; i < NUM_LEDS; ++i) {
+      const uint8_t p = (uint8_t)(phase + i * 16);
+      const uint8_t up = (p < 128) ? (uint8_t)(p * 2) : (uint8_t)(255 - (p - 128) * 2);
+      chain.setRGB(i, up, (uint8_t)(255 - up), (uint8_t)(p & 0x80 ? 64 : 0));
+    }
+  }
+
+  printStats();
+}
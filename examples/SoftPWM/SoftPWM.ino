@@ -0,0 +1,123 @@
+/**
+ * @file SoftPWM.ino
+ * @brief Dimming RGB LEDs on pins without hardware PWM (AVR, Timer2 bit-angle modulation).
+ *
+ * Wiring (Arduino Uno / Nano, no PWM on these pins):
+ *   - LED 1: RED -> 2, GREEN -> 4, BLUE -> 7
+ *   - LED 2: RED -> 8, GREEN -> 12, BLUE -> 13
+ *
+ * Notes:
+ *   - Timer2 runs in CTC mode with prescaler 256: one BAM tick = 16 us at 16 MHz.
+ *     A frame is 255 ticks (~4.1 ms, ~245 Hz) and needs only 8 interrupts.
+ *   - Timer2 is also used by tone(); do not combine the two.
+ *   - Every 2 s the sketch prints the measured refresh rate and ISR cost. Build with
+ *     -DRGBLED_SOFTPWM_ISR_TIMING=1 to also print the min/max cost of one call in
+ *     RGBLED_SOFTPWM_CYCLES units (micros by default).
+ *   - Build with -DRGBLED_ENABLE_SOFTPWM=1 -DRGBLED_ENABLE_FADE=1 (RGBLED.cpp must see the
+ *     flags too).
+ */
+
+#include "RGBLED.h"
+
+#if !RGBLED_ENABLE_SOFTPWM || !RGBLED_ENABLE_FADE
+  #error "Build this example with -DRGBLED_ENABLE_SOFTPWM=1 -DRGBLED_ENABLE_FADE=1"
+#endif
+
+RGBLED_SoftPWM softPwm;
+RGBLED led1;
+RGBLED led2;
+
+// -----------------------------------------------------------------------------
+// Timer2 BAM driver
+// -----------------------------------------------------------------------------
+
+ISR(TIMER2_COMPA_vect) {
+  OCR2A = softPwm.isr() - 1;   // next interrupt after 1, 2, 4, ... 128 ticks
+}
+
+void startTimer2() {
+  noInterrupts();
+  TCCR2A = _BV(WGM21);              // CTC
+  TCCR2B = _BV(CS22) | _BV(CS21);   // clk/256 -> 16 us per tick
+  TCNT2  = 0;
+  OCR2A  = 0;
+  TIMSK2 = _BV(OCIE2A);
+  interrupts();
+}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+void initLed(RGBLED& led, int r, int g, int b) {
+  led.parameters.RED_PIN     = r;
+  led.parameters.GREEN_PIN   = g;
+  led.parameters.BLUE_PIN    = b;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+
+  if (!led.init() || !led.attachSoftPWM(softPwm)) {
+    Serial.println(F("Init or attachSoftPWM failed"));
+    while (true) { delay(1000); }
+  }
+  led.enablePWM(true);
+}
+
+void printStats() {
+  static uint32_t tLast = 0;
+  const uint32_t now = millis();
+  if (now - tLast < 2000) return;
+
+  const RGBLED_SoftPWM::Stats s = softPwm.stats();
+  softPwm.resetStats();
+  const uint32_t elapsed = now - tLast;
+  tLast = now;
+
+  // ISR cost: time a batch of calls with the timer interrupt masked.
+  TIMSK2 = 0;
+  const uint32_t t0 = micros();
+  for (uint8_t i = 0; i < 64; ++i) softPwm.isr();
+  const uint32_t isrNs = (micros() - t0) * 1000UL / 64;
+  TIMSK2 = _BV(OCIE2A);
+
+  Serial.print(F("[SOFTPWM] refresh Hz="));
+  Serial.print(s.frames * 1000UL / elapsed);
+  Serial.print(F("  isr/s="));
+  Serial.print(s.isrCalls * 1000UL / elapsed);
+  Serial.print(F("  isr ns="));
+  Serial.print(isrNs);
+  Serial.print(F("  ports="));
+  Serial.print(softPwm.portCount());
+  Serial.print(F("  stores/frame="));
+  Serial.println(8 * softPwm.portCount());
+#if RGBLED_SOFTPWM_ISR_TIMING
+  Serial.print(F("          isr cost min/max="));
+  Serial.print(s.isrCostMin);
+  Serial.print('/');
+  Serial.println(s.isrCostMax);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void setup() {
+  Serial.begin(115200);
+
+  initLed(led1, 2, 4, 7);
+  initLed(led2, 8, 12, 13);
+  startTimer2();
+
+  led1.fadeTo(255, 60, 0, 3000);
+  led2.fadeTo(0, 40, 255, 3000);
+}
+
+void loop() {
+  led1.update();
+  led2.update();
+
+  if (!led1.isFading()) led1.fadeTo(random(256), random(256), random(256), 2000);
+  if (!led2.isFading()) led2.fadeTo(random(256), random(256), random(256), 2000);
+
+  printStats();
+}
@@ -0,0 +1,106 @@
+/**
+ * @file Stream.ino
+ * @brief Receiving binary colour frames from a PC over serial (RGBLED_StreamDecoder).
+ *
+ * Wiring (Arduino Uno / Nano):
+ *   - LED 0: RED -> 3, GREEN -> 5, BLUE -> 6
+ *   - LED 1: RED -> 9, GREEN -> 10, BLUE -> 11
+ *
+ * Notes:
+ *   - The PC sends frames built with RGBLED_streamEncode() (RGBLED_StreamProtocol.h has no
+ *     Arduino dependency and compiles into a desktop tool as-is).
+ *   - At 115200 baud a 2-LED frame is 12 bytes, i.e. about 950 frames/s on the wire.
+ *   - At startup the sketch decodes frames from RAM and prints the decoder throughput in
+ *     frames/s and CPU cycles per byte; then it prints the link statistics every 2 s.
+ */
+
+#include "RGBLED.h"
+#include "RGBLEDGroup.h"
+#include "RGBLED_Stream.h"
+
+RGBLED led0;
+RGBLED led1;
+RGBLEDGroup<2> panel;
+RGBLED_StreamDecoder<RGBLEDGroup<2>> decoder(panel);
+
+// -----------------------------------------------------------------------------
+// In-memory throughput test
+// -----------------------------------------------------------------------------
+
+/// Sink that only counts, so the measurement covers the decoder alone.
+struct NullSink {
+  uint32_t pixels = 0;
+  uint8_t size() const { return 255; }
+  void stageRGB(uint8_t, uint8_t, uint8_t, uint8_t) { ++pixels; }
+  void showRange(uint8_t, uint8_t) {}
+};
+
+void benchmarkDecoder() {
+  constexpr uint8_t LEDS = 16;
+  constexpr uint8_t FRAMES = 8;
+  static uint8_t stream[FRAMES * (RGBLED_STREAM_OVERHEAD + 3 * LEDS)];
+  uint8_t rgb[3 * LEDS];
+
+  uint16_t len = 0;
+  for (uint8_t f = 0; f < FRAMES; ++f) {
+    for (uint8_t i = 0; i < sizeof(rgb); ++i) rgb[i] = (uint8_t)(f * 31 + i * 7);
+    len += RGBLED_streamEncode(stream + len, 0, LEDS, rgb);
+  }
+
+  NullSink sink;
+  RGBLED_StreamDecoder<NullSink> dec(sink);
+  constexpr uint16_t REPS = 64;
+  uint32_t frames = 0;
+  const uint32_t t0 = micros();
+  for (uint16_t r = 0; r < REPS; ++r) frames += dec.feed(stream, len);
+  const uint32_t us = micros() - t0;
+
+  const uint32_t bytes = (uint32_t)len * REPS;
+  Serial.print(F("[STREAM] decode: frames/s="));
+  Serial.print((uint32_t)(frames * 1000000ULL / us));
+  Serial.print(F("  cycles/byte="));
+  Serial.print((uint32_t)((uint64_t)us * (F_CPU / 1000000UL) / bytes));
+  Serial.print(F("  ("));
+  Serial.print(LEDS);
+  Serial.println(F(" LEDs per frame)"));
+}
+
+// -----------------------------------------------------------------------------
+// Arduino entry points
+// -----------------------------------------------------------------------------
+
+void initLed(RGBLED& led, int r, int g, int b) {
+  led.parameters.RED_PIN     = r;
+  led.parameters.GREEN_PIN   = g;
+  led.parameters.BLUE_PIN    = b;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  if (!led.init()) {
+    Serial.println(F("Init failed"));
+    while (true) { delay(1000); }
+  }
+  led.enablePWM(true);
+  panel.add(led);
+}
+
+void setup() {
+  Serial.begin(115200);
+  initLed(led0, 3, 5, 6);
+  initLed(led1, 9, 10, 11);
+  benchmarkDecoder();
+}
+
+void loop() {
+  decoder.poll(Serial);
+  panel.update();
+
+  static uint32_t tLast = 0;
+  if (millis() - tLast >= 2000) {
+    tLast = millis();
+    Serial.print(F("[STREAM] frames="));
+    Serial.print(decoder.frames());
+    Serial.print(F("  crcErrors="));
+    Serial.print(decoder.crcErrors());
+    Serial.print(F("  headerErrors="));
+    Serial.println(decoder.headerErrors());
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file Trace.ino
+ * @brief Recording every pin write and replaying it against the expected blink schedule.
+ *
+ * Wiring:
+ *   - RED   -> pin 9
+ *   - GREEN -> pin 10
+ *   - BLUE  -> pin 11
+ *
+ * Notes:
+ *   - Build with -DRGBLED_ENABLE_TRACE=1 (RGBLED.cpp must see the flag too), e.g. in
+ *     platformio.ini: build_flags = -DRGBLED_ENABLE_TRACE=1
+ *   - Runs a finite, a blocking and an infinite blink, and replays the writes of the red pin
+ *     after each one: timing error (ms), missing/extra edges and redundant writes.
+ *   - Finally prints the raw trace as CSV ("t_ms,pin,value,elided") for offline analysis with
+ *     RGBLED_TraceReplay.h on a PC.
+ */
+
+#include "RGBLED.h"
+
+#if !RGBLED_ENABLE_TRACE
+  #error "Build this example with -DRGBLED_ENABLE_TRACE=1"
+#endif
+
+constexpr int PIN_R = 9;
+constexpr int PIN_G = 10;
+constexpr int PIN_B = 11;
+
+RGBLED led;
+RGBLED_TraceBuffer<160> trace;        // 480 bytes
+RGBLED_TraceEvent events[64];
+
+void report(const __FlashStringHelper* name, RGBLED_BlinkMode mode, uint16_t ms, uint32_t number) {
+  const uint16_t n = trace.read(events, 64);
+  const RGBLED_BlinkReport r = RGBLED_replayBlink(events, n, PIN_R, LOW, mode, ms, number);
+
+  Serial.print(F("[TRACE] "));
+  Serial.print(name);
+  Serial.print(F(": edges="));
+  Serial.print(r.matchedEdges);
+  Serial.print('/');
+  Serial.print(r.expectedEdges);
+  Serial.print(F("  err ms=["));
+  Serial.print(r.minError);
+  Serial.print(',');
+  Serial.print(r.maxError);
+  Serial.print(F("]  missing="));
+  Serial.print(r.missingEdges);
+  Serial.print(F("  extra="));
+  Serial.print(r.extraEdges);
+  Serial.print(F("  redundant="));
+  Serial.print(r.redundantWrites);
+  Serial.println(r.ok(1) ? F("  OK") : F("  MISMATCH"));
+}
+
+void runFor(uint32_t ms) {
+  const uint32_t t0 = millis();
+  while (millis() - t0 < ms) led.update();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  if (!led.init()) {
+    Serial.println(F("Init failed"));
+    while (true) { delay(1000); }
+  }
+  led.red();
+  led.off();
+  led.attachTrace(&trace);
+
+  trace.clear();
+  led.blink(1203, 4, false);                 // finite, non-blocking
+  runFor(1400);
+  report(F("finite"), RGBLED_BLINK_FINITE, 1203, 4);
+
+  trace.clear();
+  led.blink(900, 3, true);                   // blocking
+  report(F("blocking"), RGBLED_BLINK_BLOCKING, 900, 3);
+
+  trace.clear();
+  led.blink(150, 0);                         // infinite
+  runFor(2000);
+  report(F("infinite"), RGBLED_BLINK_INFINITE, 150, 0);
+  led.stopBlink();
+
+  Serial.println(F("t_ms,pin,value,elided"));
+  trace.dump(Serial);
+}
+
+void loop() {}
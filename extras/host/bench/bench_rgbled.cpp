@@ -0,0 +1,141 @@
+/**
+ * @file bench_rgbled.cpp
+ * @brief Host benchmark of the RGBLED public methods (digital and PWM modes).
+ * @details
+ *  Host counterpart of examples/Benchmark, built against the mock core in extras/host/mock.
+ *  One line per method and mode:
+ *
+ *    <mode> <method>  ns/op=<host ns per call>  calls/s=<host calls per second>
+ *                     writes/call=<pin writes per call>  core-cycles/call=<simulated AVR cycles>
+ *
+ *  - ns/op and calls/s are wall-clock numbers of this machine; use them to compare two
+ *    revisions on the same host.
+ *  - writes/call and core-cycles/call come from the mock counters and do not depend on the
+ *    host: they are the number of @c digitalWrite/@c analogWrite calls and the simulated cost
+ *    of all core calls (pin I/O, @c millis) made by one library call.
+ *
+ *  Usage: @c bench_rgbled [iterations]   (default 200000)
+ */
+
+#include "RGBLED.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static RGBLED led;
+static volatile uint8_t sink = 0;     // keeps the baseline loop from being optimized away
+static uint32_t iterations = 200000;
+static double loopOverheadNs = 0;     // cost of one empty iteration
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+typedef void (*BenchFn)(uint32_t i);
+
+static double timeLoopNs(BenchFn fn)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; ++i) fn(i);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void report(const char* mode, const char* name, BenchFn fn)
+{
+  mockResetCounters();
+  double ns = timeLoopNs(fn) / iterations - loopOverheadNs;
+  if (ns < 0) ns = 0;
+  const double writes = (double)mockPinWrites() / iterations;
+  const double cycles = (double)mockCalls.cycles / iterations;
+
+  printf("%s %-18s ns/op=%8.2f  calls/s=%12.0f  writes/call=%5.2f  core-cycles/call=%7.1f\n",
+         mode, name, ns, ns > 0 ? 1e9 / ns : 0.0, writes, cycles);
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarked operations
+// -----------------------------------------------------------------------------
+
+static void opEmpty(uint32_t i)        { sink = (uint8_t)i; }
+static void opSetSame(uint32_t)        { led.set(true, false, true); }
+static void opSetAlternate(uint32_t i) { led.set(i & 1, false, true); }
+static void opSetRGBSame(uint32_t)     { led.setRGB(200, 40, 90); }
+static void opSetRGBRamp(uint32_t i)   { led.setRGB((uint8_t)i, (uint8_t)(i >> 1), (uint8_t)(255 - i)); }
+static void opSetHSV(uint32_t i)       { led.setHSV((uint8_t)i, 255, 200); }
+static void opSetKelvin(uint32_t i)    { led.setKelvin((uint16_t)(1000 + (i & 0x1FFF)), 255); }
+static void opOn(uint32_t)             { led.on(); }
+static void opOff(uint32_t)            { led.off(); }
+static void opToggle(uint32_t)         { led.toggle(); }
+static void opInverse(uint32_t)        { led.inverse(); }
+static void opPreset(uint32_t)         { led.cyan(); }
+static void opSetBrightness(uint32_t i){ led.setBrightness((uint8_t)i); }
+static void opBlinkUpdate(uint32_t)    { led.blinkUpdate(); }
+static void opBlinkEdge(uint32_t)      { mockAdvanceMillis(1); led.blinkUpdate(); }
+static void opUpdateAt(uint32_t i)     { led.update(i * 7); }
+
+static void runSuite(const char* mode)
+{
+  report(mode, "set(same)",         opSetSame);
+  report(mode, "set(alternate)",    opSetAlternate);
+  report(mode, "setRGB(same)",      opSetRGBSame);
+  report(mode, "setRGB(ramp)",      opSetRGBRamp);
+  report(mode, "setHSV",            opSetHSV);
+  report(mode, "setKelvin",         opSetKelvin);
+  report(mode, "on()",              opOn);
+  report(mode, "off()",             opOff);
+  report(mode, "toggle()",          opToggle);
+  report(mode, "inverse()",         opInverse);
+  report(mode, "cyan()",            opPreset);
+  report(mode, "setBrightness",     opSetBrightness);
+  led.setBrightness(200);
+
+  led.stopBlink(true);
+  report(mode, "blinkUpdate(idle)", opBlinkUpdate);
+  report(mode, "update(now,idle)",  opUpdateAt);
+
+  // Infinite blink with a long half-period: every call takes the early-return path.
+  led.white();
+  led.blink(60000, 0, false);
+  report(mode, "blinkUpdate(wait)", opBlinkUpdate);
+
+  // 1 ms half-period and the clock advanced by 1 ms per call: every call fires an edge.
+  led.blink(1, 0, false);
+  report(mode, "blinkUpdate(edge)", opBlinkEdge);
+  led.stopBlink(true);
+}
+
+// -----------------------------------------------------------------------------
+// Entry point
+// -----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+  if (argc > 1) iterations = (uint32_t)strtoul(argv[1], nullptr, 10);
+  if (iterations == 0) iterations = 1;
+
+  mockReset();
+  led.parameters.RED_PIN     = 9;
+  led.parameters.GREEN_PIN   = 10;
+  led.parameters.BLUE_PIN    = 11;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  if (!led.init())
+  {
+    printf("Init failed: %s\n", reinterpret_cast<const char*>(RGBLED::errorText(led.lastError)));
+    return 1;
+  }
+
+  loopOverheadNs = timeLoopNs(opEmpty) / iterations;
+  printf("RGBLED host benchmark, iterations=%u, loop overhead ns=%.2f\n", (unsigned)iterations, loopOverheadNs);
+
+  led.enablePWM(false);
+  runSuite("[digital]");
+
+  led.enablePWM(true);
+  led.setBrightness(200);
+  runSuite("[pwm]    ");
+
+  led.off();
+  return 0;
+}
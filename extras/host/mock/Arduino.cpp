@@ -0,0 +1,197 @@
+/**
+ * @file Arduino.cpp
+ * @brief Implementation of the host mock Arduino core (see Arduino.h).
+ */
+
+#include "Arduino.h"
+
+#include <stdio.h>
+
+// ###########################################################################
+// State
+// ###########################################################################
+
+MockCounters  mockCalls = {};
+
+// Stock AVR core at 16 MHz: digitalWrite/Read resolve the pin through three PROGMEM tables
+// and turn PWM off; analogWrite also calls pinMode and programs the timer compare register.
+MockCycleCost mockCost = { 70, 60, 55, 140, 30, 45 };
+
+static uint64_t      s_us = 0;
+static uint32_t      s_usStep = 0;
+static uint8_t       s_level[NUM_DIGITAL_PINS];
+static int16_t       s_duty[NUM_DIGITAL_PINS];
+static uint8_t       s_mode[NUM_DIGITAL_PINS];
+static MockWriteHook s_hook = nullptr;
+
+static inline bool validPin(uint8_t pin) { return pin < NUM_DIGITAL_PINS; }
+
+// ###########################################################################
+// Core API
+// ###########################################################################
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  ++mockCalls.pinMode;
+  mockCalls.cycles += mockCost.pinMode;
+  if (validPin(pin)) s_mode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  ++mockCalls.digitalWrite;
+  mockCalls.cycles += mockCost.digitalWrite;
+  if (!validPin(pin)) return;
+  s_level[pin] = val ? HIGH : LOW;
+  s_duty[pin]  = -1;
+  if (s_hook) s_hook(pin, s_level[pin], false);
+}
+
+int digitalRead(uint8_t pin)
+{
+  ++mockCalls.digitalRead;
+  mockCalls.cycles += mockCost.digitalRead;
+  return validPin(pin) ? s_level[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+  ++mockCalls.analogWrite;
+  mockCalls.cycles += mockCost.analogWrite;
+  if (!validPin(pin)) return;
+  if (val < 0) val = 0;
+  if (val > 255) val = 255;
+  s_mode[pin]  = OUTPUT;
+  s_duty[pin]  = (int16_t)val;
+  s_level[pin] = val ? HIGH : LOW;
+  if (s_hook) s_hook(pin, val, true);
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val)
+{
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    const uint8_t bit = (bitOrder == LSBFIRST) ? (uint8_t)((val >> i) & 1) : (uint8_t)((val >> (7 - i)) & 1);
+    digitalWrite(dataPin, bit);
+    digitalWrite(clockPin, HIGH);
+    digitalWrite(clockPin, LOW);
+  }
+}
+
+uint32_t millis(void)
+{
+  ++mockCalls.millis;
+  mockCalls.cycles += mockCost.millis;
+  return (uint32_t)(s_us / 1000U);
+}
+
+uint32_t micros(void)
+{
+  ++mockCalls.micros;
+  mockCalls.cycles += mockCost.micros;
+  const uint32_t t = (uint32_t)s_us;
+  s_us += s_usStep;
+  return t;
+}
+
+void delay(uint32_t ms)
+{
+  ++mockCalls.delay;
+  s_us += (uint64_t)ms * 1000U;
+}
+
+void delayMicroseconds(uint32_t us) { s_us += us; }
+void yield(void) {}
+void noInterrupts(void) {}
+void interrupts(void) {}
+
+// ###########################################################################
+// Mock control
+// ###########################################################################
+
+void mockResetCounters(void) { mockCalls = MockCounters(); }
+
+void mockReset(void)
+{
+  mockResetCounters();
+  s_us = 0;
+  s_usStep = 0;
+  memset(s_level, 0, sizeof(s_level));
+  for (int16_t& d : s_duty) d = -1;
+  memset(s_mode, INPUT, sizeof(s_mode));
+  s_hook = nullptr;
+}
+
+void mockSetMillis(uint32_t ms)      { s_us = (uint64_t)ms * 1000U; }
+void mockAdvanceMillis(uint32_t ms)  { s_us += (uint64_t)ms * 1000U; }
+void mockSetMicros(uint64_t us)      { s_us = us; }
+void mockAdvanceMicros(uint32_t us)  { s_us += us; }
+void mockSetMicrosStep(uint32_t us)  { s_usStep = us; }
+
+uint32_t mockPinWrites(void) { return mockCalls.digitalWrite + mockCalls.analogWrite; }
+
+uint8_t mockPinLevel(uint8_t pin) { return validPin(pin) ? s_level[pin] : LOW; }
+int     mockPinDuty(uint8_t pin)  { return validPin(pin) ? s_duty[pin] : -1; }
+uint8_t mockPinMode(uint8_t pin)  { return validPin(pin) ? s_mode[pin] : INPUT; }
+
+void mockSetWriteHook(MockWriteHook hook) { s_hook = hook; }
+
+// ###########################################################################
+// Print / Serial
+// ###########################################################################
+
+size_t Print::write(const uint8_t* buf, size_t n)
+{
+  size_t sent = 0;
+  while (n--) sent += write(*buf++);
+  return sent;
+}
+
+size_t Print::print(long v, int base)
+{
+  if (base == DEC && v < 0) return print('-') + print((unsigned long)(-(v + 1)) + 1UL, base);
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base)
+{
+  if (base < 2) base = DEC;
+  char buf[8 * sizeof(unsigned long) + 1];
+  char* p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do
+  {
+    const unsigned d = (unsigned)(v % (unsigned)base);
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    v /= (unsigned)base;
+  } while (v);
+  return write(p);
+}
+
+size_t Print::print(double v, int digits)
+{
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  return write(buf);
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (c != '\r') fputc(c, stdout);
+  return 1;
+}
+
+void HardwareSerial::flush(void) { fflush(stdout); }
+
+int HardwareSerial::available(void) { return (int)(_rxLen - _rxPos); }
+int HardwareSerial::read(void)      { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+int HardwareSerial::peek(void)      { return _rxPos < _rxLen ? _rx[_rxPos] : -1; }
+
+void HardwareSerial::mockInject(const uint8_t* data, size_t n)
+{
+  _rx = data;
+  _rxLen = n;
+  _rxPos = 0;
+}
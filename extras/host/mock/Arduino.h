@@ -0,0 +1,211 @@
+#pragma once
+
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for building the library and its tests on a Linux host.
+ * @details
+ *  - Provides the subset the library uses: pin I/O, @c millis/@c micros/@c delay, @c F(),
+ *    @c PROGMEM accessors, @c Print and a @c Serial that writes to stdout.
+ *  - Time is virtual. It only moves through @ref mockSetMillis, @ref mockAdvanceMillis (and the
+ *    micros variants) or @c delay(), so tests are deterministic.
+ *  - Every core call is counted in @ref mockCalls and charged an AVR-like cycle cost from
+ *    @ref mockCost, so a benchmark can report pin writes and core cycles per library call.
+ *  - @c millis() and @c micros() return 32-bit values and wrap like on AVR.
+ *  - No port registers are defined, so @c RGBLED_FAST_GPIO resolves to 0 on the host.
+ *
+ * @note Host-only; never compiled by the Arduino IDE (everything below @c extras/ is ignored).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// ###########################################################################
+// Constants and types
+// ###########################################################################
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef F_CPU
+  #define F_CPU 16000000UL      ///< Clock used to turn simulated cycles into time.
+#endif
+
+#define NUM_DIGITAL_PINS 128    ///< Pins tracked by the mock (int8_t pin numbers).
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+// Program memory is ordinary memory on the host.
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p)   (*(void* const*)(p))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// ###########################################################################
+// Core API
+// ###########################################################################
+
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+void     analogWrite(uint8_t pin, int val);
+void     shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+uint32_t millis(void);
+uint32_t micros(void);
+void     delay(uint32_t ms);
+void     delayMicroseconds(uint32_t us);
+void     yield(void);
+
+void     noInterrupts(void);
+void     interrupts(void);
+
+// ###########################################################################
+// Mock control (host only)
+// ###########################################################################
+
+/// Number of calls per core function since the last @ref mockReset.
+struct MockCounters
+{
+  uint32_t pinMode;
+  uint32_t digitalWrite;
+  uint32_t digitalRead;
+  uint32_t analogWrite;
+  uint32_t millis;
+  uint32_t micros;
+  uint32_t delay;
+  uint64_t cycles;        ///< Simulated AVR cycles spent inside the core calls above.
+};
+
+/// Simulated cost of one call, in CPU cycles (defaults: ATmega328P, stock core, 16 MHz).
+struct MockCycleCost
+{
+  uint16_t pinMode;
+  uint16_t digitalWrite;
+  uint16_t digitalRead;
+  uint16_t analogWrite;
+  uint16_t millis;
+  uint16_t micros;
+};
+
+extern MockCounters  mockCalls;
+extern MockCycleCost mockCost;
+
+/// Called after every @c digitalWrite (@p pwm false) and @c analogWrite (@p pwm true).
+typedef void (*MockWriteHook)(uint8_t pin, int value, bool pwm);
+
+/** @brief Clear counters, pin states and the write hook; the clock restarts at 0. */
+void mockReset(void);
+
+/** @brief Clear the counters only. */
+void mockResetCounters(void);
+
+/** @brief Set the virtual clock (@c micros() becomes @p ms * 1000). */
+void mockSetMillis(uint32_t ms);
+
+/** @brief Advance the virtual clock by @p ms. */
+void mockAdvanceMillis(uint32_t ms);
+
+/** @brief Set the virtual clock in microseconds. */
+void mockSetMicros(uint64_t us);
+
+/** @brief Advance the virtual clock by @p us. */
+void mockAdvanceMicros(uint32_t us);
+
+/** @brief Advance the clock by @p us after every @c micros() call (0 = off, the default). */
+void mockSetMicrosStep(uint32_t us);
+
+/** @brief Total pin writes (@c digitalWrite + @c analogWrite) since the last reset. */
+uint32_t mockPinWrites(void);
+
+/** @brief Last level written with @c digitalWrite (or @c analogWrite > 0) to @p pin. */
+uint8_t mockPinLevel(uint8_t pin);
+
+/** @brief Last @c analogWrite duty of @p pin, or -1 if the last write was digital. */
+int mockPinDuty(uint8_t pin);
+
+/** @brief Last mode set with @c pinMode on @p pin (@c INPUT after reset). */
+uint8_t mockPinMode(uint8_t pin);
+
+/** @brief Install (or clear with nullptr) the write hook. */
+void mockSetWriteHook(MockWriteHook hook);
+
+// ###########################################################################
+// Print / Serial
+// ###########################################################################
+
+/**
+ * @class Print
+ * @brief Text output base class with the Arduino @c print/@c println overloads.
+ */
+class Print
+{
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t n);
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+    size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(double v, int digits = 2);
+
+    size_t println(void) { return write((const uint8_t*)"\r\n", 2); }
+    template <typename T> size_t println(T v) { const size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int fmt) { const size_t n = print(v, fmt); return n + println(); }
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port writing to stdout; reads come from an injectable buffer.
+ */
+class HardwareSerial : public Print
+{
+  public:
+    void begin(unsigned long) {}
+    void end(void) {}
+    void flush(void);
+    int  available(void);
+    int  read(void);
+    int  peek(void);
+    explicit operator bool() const { return true; }
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+
+    /** @brief Queue @p n bytes to be returned by @ref read (host only). */
+    void mockInject(const uint8_t* data, size_t n);
+
+  private:
+    const uint8_t* _rx = nullptr;
+    size_t _rxLen = 0;
+    size_t _rxPos = 0;
+};
+
+extern HardwareSerial Serial;
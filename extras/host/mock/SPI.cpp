@@ -0,0 +1,47 @@
+/**
+ * @file SPI.cpp
+ * @brief Implementation of the host mock SPI library (see SPI.h).
+ */
+
+#include "SPI.h"
+
+SPIClass         SPI;
+MockSpiState     mockSpi = {};
+MockSpiCycleCost mockSpiCost = { 4, 30 };
+
+static uint16_t s_byteCycles = 16;   // wire time of one byte in CPU cycles
+
+void SPIClass::begin(void) {}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+  // AVR divides F_CPU by 2..128; the fastest clock is F_CPU/2.
+  uint32_t clock = F_CPU / 2;
+  while (clock > settings.clock && clock > F_CPU / 128) clock /= 2;
+  s_byteCycles = (uint16_t)(8 * (F_CPU / clock));
+
+  mockSpi.clock = clock;
+  mockSpi.inTransaction = true;
+  mockSpi.logLen = 0;
+  ++mockSpi.transactions;
+  mockCalls.cycles += mockSpiCost.transaction;
+}
+
+void SPIClass::endTransaction(void) { mockSpi.inTransaction = false; }
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  if (!mockSpi.inTransaction) ++mockSpi.outsideTransaction;
+  if (mockSpi.logLen < sizeof(mockSpi.log)) mockSpi.log[mockSpi.logLen++] = data;
+  ++mockSpi.bytes;
+  mockCalls.cycles += s_byteCycles + mockSpiCost.byte;
+  return 0;
+}
+
+void SPIClass::transfer(void* buf, size_t count)
+{
+  uint8_t* p = static_cast<uint8_t*>(buf);
+  while (count--) { *p = transfer(*p); ++p; }
+}
+
+void mockSpiReset(void) { mockSpi = MockSpiState(); }
@@ -0,0 +1,73 @@
+#pragma once
+
+/**
+ * @file SPI.h
+ * @brief Host mock of the Arduino SPI library (transaction API only).
+ * @details
+ *  - Every byte is logged in @ref mockSpi and charged to @c mockCalls.cycles: the wire time at
+ *    the transaction clock (at most @c F_CPU/2, as on AVR) plus the overhead in
+ *    @ref mockSpiCost.
+ *  - The time is simulated only; the virtual clock does not move.
+ *
+ * @note Host-only; never compiled by the Arduino IDE (everything below @c extras/ is ignored).
+ */
+
+#include "Arduino.h"
+
+#define SPI_HAS_TRANSACTION 1
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/// Bus parameters of one transaction.
+class SPISettings
+{
+  public:
+    SPISettings(uint32_t clock = 4000000UL, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+
+    uint32_t clock;
+    uint8_t  bitOrder;
+    uint8_t  dataMode;
+};
+
+/// SPI peripheral; bytes go to the @ref mockSpi log.
+class SPIClass
+{
+  public:
+    void begin(void);
+    void end(void) {}
+    void beginTransaction(SPISettings settings);
+    void endTransaction(void);
+    uint8_t transfer(uint8_t data);
+    void transfer(void* buf, size_t count);
+};
+
+extern SPIClass SPI;
+
+/// Bytes seen by the mock SPI since the last @ref mockSpiReset.
+struct MockSpiState
+{
+  uint32_t bytes;             ///< Bytes transferred.
+  uint32_t transactions;      ///< beginTransaction() calls.
+  uint32_t clock;             ///< Clock of the last transaction (Hz).
+  bool     inTransaction;     ///< Between beginTransaction() and endTransaction().
+  uint32_t outsideTransaction;///< Bytes sent with no open transaction (a bug in the caller).
+  uint8_t  log[4096];         ///< First bytes of the current transaction.
+  uint16_t logLen;            ///< Bytes in @ref log (stops at its size).
+};
+
+/// Simulated CPU cycles on top of the wire time.
+struct MockSpiCycleCost
+{
+  uint16_t byte;              ///< Load SPDR, poll SPIF, read back.
+  uint16_t transaction;       ///< One begin/endTransaction pair.
+};
+
+extern MockSpiState     mockSpi;
+extern MockSpiCycleCost mockSpiCost;
+
+/** @brief Clear the SPI counters and the log. */
+void mockSpiReset(void);
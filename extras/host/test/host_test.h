@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file host_test.h
+ * @brief Minimal check macros for the host tests (no framework dependency).
+ * @details Each test is one executable: failed checks are printed with file and line, and
+ *          @c HT_RESULT() returns the process exit code for ctest.
+ */
+
+#include <stdio.h>
+
+static int ht_failures = 0;
+
+#define HT_CHECK(cond)                                                             \
+  do {                                                                             \
+    if (!(cond)) {                                                                 \
+      ++ht_failures;                                                               \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);              \
+    }                                                                              \
+  } while (0)
+
+#define HT_CHECK_EQ(a, b)                                                          \
+  do {                                                                             \
+    const long long ht_a = (long long)(a), ht_b = (long long)(b);                  \
+    if (ht_a != ht_b) {                                                            \
+      ++ht_failures;                                                               \
+      printf("%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, \
+             ht_a, ht_b);                                                          \
+    }                                                                              \
+  } while (0)
+
+#define HT_RESULT()                                                                \
+  (printf("%s: %s (%d failed checks)\n", __FILE__, ht_failures ? "FAIL" : "OK",    \
+          ht_failures), ht_failures ? 1 : 0)
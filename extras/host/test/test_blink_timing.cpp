@@ -0,0 +1,111 @@
+/**
+ * @file test_blink_timing.cpp
+ * @brief Blink engine: zero drift over millions of edges with jittered polling, stalls and a
+ *        millis() wrap; exact total duration of finite blinks, including > 127 cycles.
+ */
+
+#include "RGBLED.h"
+#include "host_test.h"
+
+static uint32_t rng = 12345;
+static uint32_t nextRandom(void) { rng = rng * 1664525UL + 1013904223UL; return rng >> 8; }
+
+static void initLed(RGBLED& led)
+{
+  led.parameters.RED_PIN     = 9;
+  led.parameters.GREEN_PIN   = 10;
+  led.parameters.BLUE_PIN    = 11;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  led.init();
+  led.white();
+}
+
+/// Infinite blink: after every poll the output and the next deadline must be exactly those of
+/// the ideal schedule start + k * halfPeriod, however late or irregular the polls are.
+static void infiniteNoDrift(uint16_t halfPeriod, uint32_t start, uint32_t edges, uint32_t maxJitter)
+{
+  RGBLED led;
+  initLed(led);
+  mockSetMillis(start);
+  led.blink(halfPeriod, 0, false);
+
+  const uint32_t end = start + edges * halfPeriod;   // may wrap past 2^32
+  uint32_t now = start;
+  uint32_t polls = 0, mismatches = 0, lastK = 0;
+
+  while ((int32_t)(end - now) > 0)
+  {
+    // Mostly small steps, sometimes a stall of several periods.
+    const uint32_t r = nextRandom();
+    now += (r % 16 == 0) ? (uint32_t)(halfPeriod * (3 + r % 5) + r % halfPeriod) : (uint32_t)(r % (maxJitter + 1));
+    led.update(now);
+    ++polls;
+
+    const uint32_t k = (now - start) / halfPeriod;          // edges due so far
+    uint32_t deadline = 0;
+    const bool ok = led.isBlinking() && led.nextDeadlineMs(deadline) &&
+                    deadline == start + (k + 1) * halfPeriod &&
+                    led.isOn() == ((k & 1) == 0);
+    if (!ok) ++mismatches;
+    lastK = k;
+  }
+
+  HT_CHECK_EQ(mismatches, 0);
+  HT_CHECK(lastK >= edges);
+  printf("infinite half-period=%u ms: %u edges, %u polls, start=0x%08X, drift=0\n",
+         halfPeriod, (unsigned)lastK, (unsigned)polls, (unsigned)start);
+}
+
+/// Finite blink polled every millisecond: each edge lands on start + i*delay + min(i, rem),
+/// and the sequence ends exactly at start + duration.
+static void finiteExact(uint16_t duration, uint32_t number, uint32_t start)
+{
+  RGBLED led;
+  initLed(led);
+  mockSetMillis(start);
+  led.blink(duration, number, false);
+
+  const uint32_t edges = 2 * number;
+  const uint32_t delayMs = duration / edges;
+  const uint32_t rem = duration % edges;
+
+  uint32_t toggles = 0, mismatches = 0;
+  bool wasOn = led.isOn();
+  uint32_t i = 0;                                         // edges due so far
+  for (uint32_t t = 1; t <= duration + 5u; ++t)
+  {
+    const uint32_t now = start + t;
+    led.update(now);
+    while (i < edges && t >= (i + 1) * delayMs + ((i + 1) < rem ? (i + 1) : rem)) ++i;
+
+    const bool expectBlinking = (i < edges);
+    const bool expectOn = expectBlinking && (i & 1) == 0;
+    if (led.isBlinking() != expectBlinking || led.isOn() != expectOn) ++mismatches;
+    if (!led.isBlinking() && t < duration) ++mismatches;   // never ends early
+    if (led.isOn() != wasOn) { ++toggles; wasOn = led.isOn(); }
+  }
+
+  HT_CHECK_EQ(mismatches, 0);
+  HT_CHECK_EQ(toggles, edges - 1);                        // the final (DONE) edge keeps it OFF
+  HT_CHECK(!led.isBlinking());
+  printf("finite %u ms x %u cycles: delay=%u rem=%u, ends at +%u ms exactly\n",
+         duration, (unsigned)number, (unsigned)delayMs, (unsigned)rem, duration);
+}
+
+int main()
+{
+  mockReset();
+
+  // Millions of edges with jitter and stalls; the first run crosses the 2^32 ms wrap.
+  infiniteNoDrift(1,   0xFFF00000UL, 3000000UL, 3);
+  infiniteNoDrift(7,   0x10000000UL, 1000000UL, 20);
+  infiniteNoDrift(500, 0xFFFFFF00UL, 20000UL,  1200);
+
+  // Remainder distribution and counts above the old 8-bit limit.
+  finiteExact(1000,  3,     0);
+  finiteExact(65535, 7,     0xFFFFF000UL);
+  finiteExact(65535, 1000,  42);
+  finiteExact(65535, 20000, 0xFFFFFFF0UL);
+
+  return HT_RESULT();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_color.cpp
+ * @brief Integer colour conversions against float references (those of
+ *        examples/ColorConversion): HSV within 2 counts, forward and as an RGB -> HSV -> RGB
+ *        round trip, and Kelvin within 4 counts over the whole table range.
+ */
+
+#include "RGBLED.h"
+#include "host_test.h"
+
+// Textbook HSV to RGB, h in degrees, s and v in 0..1, result in 0..255.
+static void hsvFloat(float hDeg, float s, float v, float &r, float &g, float &b)
+{
+  const float c = v * s;
+  const float hp = hDeg / 60.0f;
+  const float x = c * (1.0f - fabsf(fmodf(hp, 2.0f) - 1.0f));
+  float r1 = 0, g1 = 0, b1 = 0;
+  if      (hp < 1) { r1 = c; g1 = x; }
+  else if (hp < 2) { r1 = x; g1 = c; }
+  else if (hp < 3) { g1 = c; b1 = x; }
+  else if (hp < 4) { g1 = x; b1 = c; }
+  else if (hp < 5) { r1 = x; b1 = c; }
+  else             { r1 = c; b1 = x; }
+  const float m = v - c;
+  r = (r1 + m) * 255.0f; g = (g1 + m) * 255.0f; b = (b1 + m) * 255.0f;
+}
+
+// Inverse of hsvFloat: h in degrees [0, 360), s and v in 0..1.
+static void rgbToHsvFloat(float r, float g, float b, float &hDeg, float &s, float &v)
+{
+  const float mx = fmaxf(r, fmaxf(g, b)), mn = fminf(r, fminf(g, b)), d = mx - mn;
+  v = mx / 255.0f;
+  s = (mx > 0) ? d / mx : 0;
+  if (d == 0)       hDeg = 0;
+  else if (mx == r) hDeg = 60.0f * fmodf((g - b) / d + 6.0f, 6.0f);
+  else if (mx == g) hDeg = 60.0f * ((b - r) / d + 2.0f);
+  else              hDeg = 60.0f * ((r - g) / d + 4.0f);
+  if (hDeg >= 360.0f) hDeg -= 360.0f;
+}
+
+static float clamp255(float x) { return x < 0 ? 0 : (x > 255 ? 255 : x); }
+
+// Tanner Helland's black-body curve fit.
+static void kelvinFloat(uint16_t k, float &r, float &g, float &b)
+{
+  const float t = k / 100.0f;
+  r = (t <= 66) ? 255 : clamp255(329.698727446f * powf(t - 60, -0.1332047592f));
+  g = (t <= 66) ? clamp255(99.4708025861f * logf(t) - 161.1195681661f)
+                : clamp255(288.1221695283f * powf(t - 60, -0.0755148492f));
+  b = (t >= 66) ? 255 : ((t <= 19) ? 0 : clamp255(138.5177312231f * logf(t - 10) - 305.0447927307f));
+}
+
+// Largest per-channel difference, in counts (rounded).
+static int maxErr(uint8_t r, uint8_t g, uint8_t b, float fr, float fg, float fb)
+{
+  float e = fabsf(r - fr);
+  if (fabsf(g - fg) > e) e = fabsf(g - fg);
+  if (fabsf(b - fb) > e) e = fabsf(b - fb);
+  return (int)(e + 0.5f);
+}
+
+int main()
+{
+  uint8_t r, g, b;
+  float fr, fg, fb;
+
+  // Every 8-bit hue, saturation and value.
+  int worstHsv8 = 0;
+  for (uint16_t h = 0; h < 256; ++h)
+    for (uint16_t s = 0; s < 256; ++s)
+      for (uint16_t v = 0; v < 256; ++v)
+      {
+        RGBLED_hsvToRgb((uint8_t)h, (uint8_t)s, (uint8_t)v, r, g, b);
+        hsvFloat(h * 360.0f / 256.0f, s / 255.0f, v / 255.0f, fr, fg, fb);
+        const int e = maxErr(r, g, b, fr, fg, fb);
+        if (e > worstHsv8) worstHsv8 = e;
+      }
+
+  int worstHsv16 = 0;
+  for (uint32_t h = 0; h < 65536; ++h)
+    for (uint16_t sv = 0; sv < 256; sv += 15)
+    {
+      RGBLED_hsv16ToRgb((uint16_t)h, (uint8_t)sv, (uint8_t)(255 - sv), r, g, b);
+      hsvFloat(h * 360.0f / 65536.0f, sv / 255.0f, (255 - sv) / 255.0f, fr, fg, fb);
+      const int e = maxErr(r, g, b, fr, fg, fb);
+      if (e > worstHsv16) worstHsv16 = e;
+    }
+
+  // RGB -> float HSV -> 16-bit hue, 8-bit s and v -> integer RGB: back to the start.
+  int worstTrip = 0;
+  for (uint16_t r0 = 0; r0 < 256; r0 += 3)
+    for (uint16_t g0 = 0; g0 < 256; g0 += 3)
+      for (uint16_t b0 = 0; b0 < 256; b0 += 3)
+      {
+        float hDeg, s, v;
+        rgbToHsvFloat(r0, g0, b0, hDeg, s, v);
+        const uint16_t h16 = (uint16_t)((uint32_t)(hDeg * 65536.0f / 360.0f + 0.5f) & 0xFFFF);
+        RGBLED_hsv16ToRgb(h16, (uint8_t)(s * 255.0f + 0.5f), (uint8_t)(v * 255.0f + 0.5f), r, g, b);
+        const int e = maxErr(r, g, b, r0, g0, b0);
+        if (e > worstTrip) worstTrip = e;
+      }
+
+  // Every temperature of the table range.
+  int worstKelvin = 0;
+  for (uint16_t k = RGBLED_KELVIN_MIN; k <= RGBLED_KELVIN_MAX; ++k)
+  {
+    RGBLED_kelvinToRgb(k, r, g, b);
+    kelvinFloat(k, fr, fg, fb);
+    const int e = maxErr(r, g, b, fr, fg, fb);
+    if (e > worstKelvin) worstKelvin = e;
+  }
+
+  printf("max error: hsv8 %d, hsv16 %d, rgb->hsv->rgb %d, kelvin %d counts\n",
+         worstHsv8, worstHsv16, worstTrip, worstKelvin);
+  HT_CHECK(worstHsv8 <= 2);
+  HT_CHECK(worstHsv16 <= 2);
+  HT_CHECK(worstTrip <= 2);
+  HT_CHECK(worstKelvin <= 4);
+
+  return HT_RESULT();
+}
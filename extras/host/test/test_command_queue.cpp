@@ -0,0 +1,171 @@
+/**
+ * @file test_command_queue.cpp
+ * @brief Command queue under a real producer thread: no loss, FIFO order and the final LED
+ *        state after coalescing drains. Reports throughput and post-to-pop latency.
+ *        Also checks that a queued blink has the arguments of RGBLED::blink.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_CommandQueue.h"
+#include "host_test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t nowNs(void)
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+static void initLed(RGBLED& led, uint8_t firstPin)
+{
+  led.parameters.RED_PIN     = firstPin;
+  led.parameters.GREEN_PIN   = (int8_t)(firstPin + 1);
+  led.parameters.BLUE_PIN    = (int8_t)(firstPin + 2);
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  led.init();
+  led.enablePWM(true);
+}
+
+/// Producer posts a sequence number in every command; the consumer pops them one by one.
+static void popHammer(uint32_t count)
+{
+  static RGBLED_CommandQueue<64> queue;
+  std::vector<uint64_t> postedAt(count), latency(count);
+  std::atomic<uint32_t> fullRetries(0);
+
+  const uint64_t t0 = nowNs();
+  std::thread producer([&]() {
+    uint32_t retries = 0;
+    for (uint32_t seq = 0; seq < count; ++seq)
+    {
+      RGBLED_Command c;
+      c.op = RGBLED_CMD_RGB;
+      c.led = 0;
+      c.ms = (uint16_t)seq;
+      c.rgb[0] = (uint8_t)(seq >> 16); c.rgb[1] = (uint8_t)(seq >> 24); c.rgb[2] = 0; c.rgb[3] = 0;
+      postedAt[seq] = nowNs();            // published by the release store in post()
+      while (!queue.post(c)) { ++retries; std::this_thread::yield(); postedAt[seq] = nowNs(); }
+    }
+    fullRetries = retries;
+  });
+
+  uint32_t received = 0, outOfOrder = 0;
+  RGBLED_Command c;
+  while (received < count)
+  {
+    if (!queue.pop(c)) { std::this_thread::yield(); continue; }
+    const uint64_t t = nowNs();
+    const uint32_t seq = c.ms | ((uint32_t)c.rgb[0] << 16) | ((uint32_t)c.rgb[1] << 24);
+    if (seq != received) { ++outOfOrder; if (seq >= count) break; }
+    latency[received] = t - postedAt[seq];
+    ++received;
+  }
+  producer.join();
+  const double seconds = (double)(nowNs() - t0) / 1e9;
+
+  HT_CHECK_EQ(received, count);
+  HT_CHECK_EQ(outOfOrder, 0);
+  HT_CHECK_EQ(queue.pending(), 0);
+
+  std::sort(latency.begin(), latency.end());
+  printf("pop hammer: %u commands in %.3f s = %.2f M/s, queue full %u times, "
+         "latency p50 %llu ns, p99 %llu ns, max %llu ns\n",
+         (unsigned)count, seconds, count / seconds / 1e6, (unsigned)fullRetries.load(),
+         (unsigned long long)latency[count / 2], (unsigned long long)latency[count * 99ull / 100],
+         (unsigned long long)latency[count - 1]);
+}
+
+/// Producer posts colour bursts to four LEDs; the consumer drains into real RGBLED objects.
+/// Every post is either applied or coalesced, and each LED ends on its last posted colour.
+static void drainHammer(uint32_t count)
+{
+  static const uint8_t LEDS = 4;
+  static RGBLED_CommandQueue<64, LEDS> queue;
+  RGBLED led[LEDS];
+  RGBLED* leds[LEDS];
+  for (uint8_t i = 0; i < LEDS; ++i) { initLed(led[i], (uint8_t)(2 + 3 * i)); leds[i] = &led[i]; }
+
+  uint8_t last[LEDS][3] = {};
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> fullRetries(0);
+
+  const uint64_t t0 = nowNs();
+  std::thread producer([&]() {
+    uint32_t retries = 0;
+    for (uint32_t n = 0; n < count; ++n)
+    {
+      const uint8_t i = (uint8_t)(n % LEDS);
+      const uint8_t r = (uint8_t)n, g = (uint8_t)(n >> 8), b = (uint8_t)(n * 7);
+      while (!queue.postRGB(i, r, g, b)) { ++retries; std::this_thread::yield(); }
+      last[i][0] = r; last[i][1] = g; last[i][2] = b;
+      if (n % 1000 == 0) while (!queue.postBrightness(i, 255)) { ++retries; std::this_thread::yield(); }
+    }
+    fullRetries = retries;
+    done = true;
+  });
+
+  uint32_t applied = 0, drains = 0;
+  while (!done.load() || queue.pending())
+  {
+    const uint8_t n = queue.drain(leds);
+    if (n) { applied += n; ++drains; }
+    else   std::this_thread::yield();
+  }
+  producer.join();
+  applied += queue.drain(leds);
+  const double seconds = (double)(nowNs() - t0) / 1e9;
+
+  const uint32_t brightness = (count + 999) / 1000;
+  HT_CHECK_EQ(applied + queue.coalesced(), count + brightness);
+  HT_CHECK_EQ(queue.dropped(), (uint8_t)fullRetries.load());   // rejected posts, 8-bit counter
+  for (uint8_t i = 0; i < LEDS; ++i)
+  {
+    const uint8_t pin = (uint8_t)(2 + 3 * i);
+    HT_CHECK_EQ(mockPinDuty(pin),     last[i][0]);
+    HT_CHECK_EQ(mockPinDuty(pin + 1), last[i][1]);
+    HT_CHECK_EQ(mockPinDuty(pin + 2), last[i][2]);
+  }
+  printf("drain hammer: %u posts in %.3f s = %.2f M/s, %u drains, %u applied, %u coalesced\n",
+         (unsigned)(count + brightness), seconds, (count + brightness) / seconds / 1e6,
+         (unsigned)drains, (unsigned)applied, (unsigned)queue.coalesced());
+}
+
+/// A queued blink behaves like RGBLED::blink: ms is the total time of a finite blink.
+static void blinkArguments(void)
+{
+  RGBLED_CommandQueue<4> queue;
+  RGBLED led;
+  initLed(led, 40);
+  led.white();
+  mockSetMillis(0);
+  queue.postBlink(0, 1000, 2);
+  queue.drain(led);
+  led.update(999);
+  HT_CHECK(led.isBlinking());
+  led.update(1000);
+  HT_CHECK(!led.isBlinking());
+
+  mockSetMillis(1000);
+  queue.postBlink(0, 300, 0);                // endless: 300 ms per ON or OFF interval
+  queue.drain(led);
+  uint32_t deadline = 0;
+  HT_CHECK(led.nextDeadlineMs(deadline));
+  HT_CHECK_EQ(deadline, 1300);
+}
+
+int main()
+{
+  mockReset();
+
+  blinkArguments();
+  popHammer(1000000UL);
+  drainHammer(1000000UL);
+
+  return HT_RESULT();
+}
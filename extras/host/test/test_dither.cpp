@@ -0,0 +1,148 @@
+/**
+ * @file test_dither.cpp
+ * @brief Temporal dithering: the duty averaged over 256 frames equals the 8.8 target within
+ *        1/256 of a step, for 16-bit colours, brightness, active-low wiring, late polling and
+ *        slow color fades. Built with RGBLED_ENABLE_DITHER=1 and RGBLED_ENABLE_FADE=1.
+ */
+
+#include "RGBLED.h"
+#include "host_test.h"
+
+static const uint8_t PIN_R = 9, PIN_G = 10, PIN_B = 11;
+
+static uint32_t rng = 2024;
+static uint32_t nextRandom(void) { rng = rng * 1664525UL + 1013904223UL; return rng >> 8; }
+
+static void initLed(RGBLED& led, RGBLED_ActiveMode mode)
+{
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = mode;
+  led.init();
+  led.enablePWM(true);
+}
+
+/// Sum of the shown R/G/B duty over 256 dither frames, one update per frame.
+static void frameSum(RGBLED& led, bool activeLow, uint32_t& now, uint8_t frameMs, uint32_t sum[3])
+{
+  const uint8_t pins[3] = { PIN_R, PIN_G, PIN_B };
+  sum[0] = sum[1] = sum[2] = 0;
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    led.update(now);
+    for (uint8_t c = 0; c < 3; ++c)
+    {
+      const int duty = mockPinDuty(pins[c]);
+      sum[c] += activeLow ? (uint32_t)(255 - duty) : (uint32_t)duty;
+    }
+    now += frameMs;
+  }
+}
+
+/// Static 16-bit colours at random brightness: sum over 256 frames vs the exact 8.8 value
+/// (colour * 255/65535 * brightness/255 * 256).
+static void staticColors(RGBLED_ActiveMode mode, uint8_t frameMs, uint32_t cases)
+{
+  const bool activeLow = (mode == RGBLED_ACTIVE_LOW);
+  RGBLED led;
+  initLed(led, mode);
+  uint32_t now = 1000;
+  mockSetMillis(now);
+  led.enableDither(frameMs);
+
+  double worst = 0;
+  uint32_t failures = 0;
+  for (uint32_t n = 0; n < cases; ++n)
+  {
+    const uint16_t v[3] = { (uint16_t)nextRandom(), (uint16_t)(nextRandom() & 0x03FF), (uint16_t)(n * 257 + 1) };
+    const uint8_t bri = (n % 4 == 0) ? 255 : (uint8_t)(1 + nextRandom() % 255);
+    led.setBrightness(bri);
+    mockSetMillis(now);
+    led.setRGB16(v[0], v[1], v[2]);
+
+    uint32_t sum[3];
+    frameSum(led, activeLow, now, frameMs, sum);
+    for (uint8_t c = 0; c < 3; ++c)
+    {
+      const double exact = (double)v[c] * bri * 256.0 / 65535.0;
+      const double err = fabs((double)sum[c] - exact);
+      if (err > worst) worst = err;
+      if (err > 1.0) ++failures;
+    }
+  }
+
+  HT_CHECK_EQ(failures, 0);
+  printf("static %s, %u ms frames: %u colours, worst |avg - target| = %.3f / 256 step\n",
+         activeLow ? "active-low " : "active-high", frameMs, (unsigned)cases, worst);
+}
+
+/// A loop slower than the frame rate skips frames instead of bursting them; every frame that
+/// is shown still belongs to the 256-frame cycle, so the average over 256 polls holds.
+static void latePolling(void)
+{
+  RGBLED led;
+  initLed(led, RGBLED_ACTIVE_HIGH);
+  uint32_t now = 0;
+  mockSetMillis(now);
+  led.enableDither(2);
+  led.setRGB16(0x1280, 0, 0);              // 18.43 steps
+
+  uint32_t sum = 0;
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    now += 2 + (nextRandom() % 7);         // always at least one frame due
+    led.update(now);
+    sum += (uint32_t)mockPinDuty(PIN_R);
+  }
+  const double exact = 0x1280 * 255.0 * 256.0 / 65535.0;
+  HT_CHECK(fabs((double)sum - exact) <= 1.0);
+  printf("late polling: sum %u, target %.3f\n", (unsigned)sum, exact);
+}
+
+/// Slow fade from 0 to 4 over 65535 ms: each 256-frame window averages the fade's 8.8 values
+/// (progress f = e * ceil(2^32 / duration) >> 16, value = 4 * f >> 8) within 1/256 step.
+static void slowFade(void)
+{
+  RGBLED led;
+  initLed(led, RGBLED_ACTIVE_HIGH);
+  uint32_t now = 5000;
+  mockSetMillis(now);
+  led.enableDither(1);
+  led.setRGB(0, 0, 0);
+  led.fadeTo(4, 0, 0, 65535);
+
+  double worst = 0;
+  uint32_t failures = 0;
+  const uint32_t start = now;
+  for (uint32_t w = 0; w < 255; ++w)
+  {
+    uint32_t sum = 0;
+    double ideal = 0;
+    for (uint16_t i = 0; i < 256; ++i)
+    {
+      led.update(now);
+      sum += (uint32_t)mockPinDuty(PIN_R);
+      const uint32_t f = (uint32_t)(((uint64_t)(now - start) * RGBLED_phaseRate(65535)) >> 16);
+      ideal += (double)((4 * f) >> 8) / 256.0;          // in steps
+      ++now;
+    }
+    const double err = fabs((double)sum - ideal);
+    if (err > worst) worst = err;
+    if (err > 1.0) ++failures;
+  }
+  HT_CHECK_EQ(failures, 0);
+  printf("slow fade 0 -> 4 over 65535 ms: worst window error %.3f / 256 step\n", worst);
+}
+
+int main()
+{
+  mockReset();
+
+  staticColors(RGBLED_ACTIVE_HIGH, 1, 2000);
+  staticColors(RGBLED_ACTIVE_LOW,  5, 500);
+  latePolling();
+  slowFade();
+
+  return HT_RESULT();
+}
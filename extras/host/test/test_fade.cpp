@@ -0,0 +1,158 @@
+/**
+ * @file test_fade.cpp
+ * @brief Color and brightness fades: monotonic, at most one count per step on slow fades
+ *        (including the last step onto the target), exact end time, and correct timing when
+ *        both fades run with starts far apart. Built with RGBLED_ENABLE_FADE=1.
+ */
+
+#include "RGBLED.h"
+#include "host_test.h"
+
+static const uint8_t PIN_R = 9, PIN_G = 10, PIN_B = 11;
+
+static void initLed(RGBLED& led)
+{
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = PIN_B;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  led.init();
+  led.enablePWM(true);
+}
+
+/// Color fade of the red channel polled every ms: largest step, direction and end time.
+static void colorFade(uint8_t from, uint8_t to, uint16_t duration, uint32_t start)
+{
+  RGBLED led;
+  initLed(led);
+  mockSetMillis(start);
+  led.setRGB(from, 0, 0);
+  led.fadeTo(to, 0, 0, duration);
+
+  const int dir = (to > from) ? 1 : -1;
+  int prev = from, maxStep = 0, lastStep = 0;
+  uint32_t wrongWay = 0, endedEarly = 0;
+  for (uint32_t t = 1; t <= duration; ++t)
+  {
+    led.update(start + t);
+    const int v = mockPinDuty(PIN_R);
+    const int step = (v - prev) * dir;
+    if (step < 0) ++wrongWay;
+    if (step > maxStep) maxStep = step;
+    if (v != prev) lastStep = step;
+    if (t < duration && !led.isFading()) ++endedEarly;
+    prev = v;
+  }
+
+  // Steps of at most ceil(range / duration) counts, plus one for rounding.
+  const int range = (to > from) ? to - from : from - to;
+  const int limit = (range + duration - 1) / duration + 1;
+  HT_CHECK_EQ(wrongWay, 0);
+  HT_CHECK_EQ(endedEarly, 0);
+  HT_CHECK_EQ(prev, to);
+  HT_CHECK(!led.isFading());
+  HT_CHECK(maxStep <= limit);
+  HT_CHECK(lastStep <= limit);
+  printf("fade %3u -> %3u over %5u ms: max step %d, last step %d (limit %d)\n",
+         from, to, duration, maxStep, lastStep, limit);
+}
+
+/// Brightness fade polled every ms: the duty of a full-on channel follows the brightness.
+static void brightnessFade(uint8_t from, uint8_t to, uint16_t duration)
+{
+  RGBLED led;
+  initLed(led);
+  mockSetMillis(0);
+  led.setBrightness(from);
+  led.setRGB(255, 255, 255);
+  led.fadeBrightness(to, duration);
+
+  const int dir = (to > from) ? 1 : -1;
+  int prev = from, maxStep = 0;
+  uint32_t wrongWay = 0;
+  for (uint32_t t = 1; t <= duration; ++t)
+  {
+    led.update(t);
+    const int v = mockPinDuty(PIN_G);
+    const int step = (v - prev) * dir;
+    if (step < 0) ++wrongWay;
+    if (step > maxStep) maxStep = step;
+    prev = v;
+  }
+  HT_CHECK_EQ(wrongWay, 0);
+  HT_CHECK_EQ(prev, to);
+  HT_CHECK(maxStep <= 1);
+  printf("brightness %3u -> %3u over %5u ms: max step %d\n", from, to, duration, maxStep);
+}
+
+/// Both fades share one start time plus a 16-bit offset: check each keeps its own timing.
+static void overlappingFades(void)
+{
+  RGBLED led;
+  initLed(led);
+
+  // Colour fade first, brightness fade 30 s later: both end on time.
+  mockSetMillis(1000);
+  led.setRGB(0, 0, 0);
+  led.fadeTo(200, 0, 0, 40000);
+  mockSetMillis(31000);
+  led.fadeBrightness(55, 20000);
+  led.update(41000);                          // colour done, brightness half way
+  const int mid = mockPinDuty(PIN_R);
+  HT_CHECK(mid >= RGBLED_scale8(200, 154) && mid <= RGBLED_scale8(200, 156));
+  led.update(50999);
+  HT_CHECK(led.isFading());
+  led.update(51000);
+  HT_CHECK(!led.isFading());
+  HT_CHECK_EQ(mockPinDuty(PIN_R), RGBLED_scale8(200, 55));
+
+  // Brightness fade first, colour fade 10 s later: starts in the other order.
+  mockSetMillis(100000);
+  led.setBrightness(255);
+  led.fadeBrightness(0, 30000);
+  mockSetMillis(110000);
+  led.fadeTo(0, 0, 0, 5000);
+  led.update(115000);
+  HT_CHECK_EQ(mockPinDuty(PIN_R), 0);
+  led.update(129999);
+  HT_CHECK(led.isFading());
+  led.update(130000);
+  HT_CHECK(!led.isFading());
+
+  // A fade left unpolled for longer than 65535 ms: starting the other fade must not revive
+  // or stretch it; the stale one finishes at the next update and the new one keeps its time.
+  mockSetMillis(200000);
+  led.setBrightness(255);
+  led.setRGB(100, 0, 0);
+  led.fadeBrightness(10, 1000);
+  mockSetMillis(400000);
+  led.fadeTo(200, 0, 0, 2000);
+  led.update(400000);
+  HT_CHECK_EQ(mockPinDuty(PIN_R), RGBLED_scale8(100, 10));
+  led.update(401000);
+  HT_CHECK_EQ(mockPinDuty(PIN_R), RGBLED_scale8(150, 10));
+  led.update(402000);
+  HT_CHECK(!led.isFading());
+  HT_CHECK_EQ(mockPinDuty(PIN_R), RGBLED_scale8(200, 10));
+}
+
+int main()
+{
+  mockReset();
+
+  // Slow fades: the old 16.16 reciprocal truncated to 6 (10 s) or 1 (40 s) and jumped by
+  // 22 / 100 counts on the last step.
+  colorFade(0,   255, 10000, 0);
+  colorFade(0,   255, 40000, 0xFFFFC000UL);   // crosses the millis() wrap
+  colorFade(255, 0,   40000, 12345);
+  colorFade(17,  230, 65535, 0);
+  colorFade(0,   255, 100,   0);
+  colorFade(255, 3,   7,     0);
+
+  brightnessFade(255, 0, 10000);
+  brightnessFade(0, 255, 40000);
+
+  overlappingFades();
+
+  return HT_RESULT();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file test_fixed.cpp
+ * @brief RGBLED_Fixed: no init guard, tickless update(now)/nextDeadlineMs, active-low folding,
+ *        elided-write count in the default build (RGBLED and RGBLED_Fixed).
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Fixed.h"
+#include "host_test.h"
+
+static RGBLED_Fixed<3, 5, 6, RGBLED_ACTIVE_LOW> led;
+
+int main()
+{
+  mockReset();
+  HT_CHECK(led.init());
+
+  // Active-low: OFF is HIGH on every pin after init.
+  HT_CHECK_EQ(mockPinLevel(3), HIGH);
+  HT_CHECK_EQ(mockPinLevel(5), HIGH);
+  HT_CHECK_EQ(mockPinLevel(6), HIGH);
+
+  led.red();
+  HT_CHECK_EQ(mockPinLevel(3), LOW);
+  HT_CHECK_EQ(mockPinLevel(5), HIGH);
+
+  // Idle: no deadline, update() does not read the clock.
+  uint32_t deadline = 0;
+  HT_CHECK(!led.nextDeadlineMs(deadline));
+  mockResetCounters();
+  led.update();
+  HT_CHECK_EQ(mockCalls.millis, 0);
+
+  // Finite non-blocking blink: 3 cycles in 600 ms -> edges every 100 ms from t = 1000.
+  mockSetMillis(1000);
+  led.blink(600, 3, false);
+  HT_CHECK(led.isBlinking());
+  HT_CHECK(led.nextDeadlineMs(deadline));
+  HT_CHECK_EQ(deadline, 1100);
+
+  uint32_t edges = 0;
+  bool wasOn = led.isOn();
+  for (uint32_t t = 1000; t <= 1700; ++t)
+  {
+    led.update(t);
+    if (led.isOn() != wasOn) { ++edges; wasOn = led.isOn(); }
+  }
+  HT_CHECK_EQ(edges, 5);          // ON->OFF x3, OFF->ON x2
+  HT_CHECK(!led.isBlinking());
+  HT_CHECK(!led.isOn());
+  HT_CHECK(!led.nextDeadlineMs(deadline));
+
+  // PWM: duties inverted at compile time, brightness applied.
+  led.enablePWM(true);
+  led.setBrightness(255);
+  led.setRGB(255, 128, 0);
+  HT_CHECK_EQ(mockPinDuty(3), 0);
+  HT_CHECK_EQ(mockPinDuty(5), 127);
+  HT_CHECK_EQ(mockPinDuty(6), 255);
+
+  // Leaving PWM takes the pins back with digital writes.
+  led.enablePWM(false);
+  HT_CHECK_EQ(mockPinDuty(3), -1);
+  HT_CHECK_EQ(mockPinLevel(3), LOW);
+
+  // Elided writes are counted without RGBLED_ENABLE_STATS: a repeated colour skips all three.
+  led.resetElidedWrites();
+  mockResetCounters();
+  led.setRGB(10, 20, 30);
+  led.setRGB(10, 20, 30);
+  HT_CHECK_EQ(led.elidedWrites() + mockPinWrites(), 6);
+  HT_CHECK(led.elidedWrites() >= 3);
+
+  RGBLED dyn;
+  dyn.parameters.RED_PIN = 9; dyn.parameters.GREEN_PIN = 10; dyn.parameters.BLUE_PIN = 11;
+  dyn.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  dyn.init();
+  dyn.enablePWM(true);
+  dyn.setRGB(1, 2, 3);
+  dyn.resetElidedWrites();
+  mockResetCounters();
+  dyn.setRGB(1, 2, 3);
+  dyn.setRGB(1, 2, 4);
+  HT_CHECK_EQ(dyn.elidedWrites(), 5);
+  HT_CHECK_EQ(mockPinWrites(), 1);
+
+  return HT_RESULT();
+}
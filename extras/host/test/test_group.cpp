@@ -0,0 +1,131 @@
+/**
+ * @file test_group.cpp
+ * @brief RGBLEDGroup blinks: after a loop stall each LED jumps straight to the phase of the ideal
+ *        schedule with at most one write, and finite blinks keep their cycle count; members
+ *        added after setBrightness take the group brightness.
+ */
+
+#include "RGBLED.h"
+#include "RGBLEDGroup.h"
+#include "host_test.h"
+
+static const uint8_t LEDS = 4;
+static RGBLED members[LEDS];
+
+static uint32_t rng = 777;
+static uint32_t nextRandom(void) { rng = rng * 1664525UL + 1013904223UL; return rng >> 8; }
+
+static uint8_t pinOf(uint8_t led) { return (uint8_t)(2 + 3 * led); }
+
+/// Red channel of member @p i lit, on the PWM or the digital path.
+static bool lit(uint8_t i)
+{
+  const int duty = mockPinDuty(pinOf(i));
+  return duty >= 0 ? duty > 0 : mockPinLevel(pinOf(i)) == HIGH;
+}
+
+static void initMember(uint8_t i)
+{
+  members[i].parameters.RED_PIN     = pinOf(i);
+  members[i].parameters.GREEN_PIN   = pinOf(i) + 1;
+  members[i].parameters.BLUE_PIN    = pinOf(i) + 2;
+  members[i].parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  members[i].init();
+  members[i].enablePWM(true);
+}
+
+/// Writes to the red pins of all members.
+static uint32_t redWrites[LEDS];
+static void countWrites(uint8_t pin, int, bool)
+{
+  for (uint8_t i = 0; i < LEDS; ++i) if (pin == pinOf(i)) ++redWrites[i];
+}
+
+/// Polls with random steps and stalls of up to 7 half-periods; every poll must show the ideal
+/// phase (edge k at t0 + k * half, lit while k is even, dark after 2 * cycles edges) and touch
+/// each red pin at most once.
+static void stallCatchUp(void)
+{
+  RGBLEDGroup<LEDS> group;
+  const uint16_t half[LEDS]   = { 100, 37, 250, 61 };
+  const uint16_t cycles[LEDS] = { 0, 40, 0, 9 };
+  for (uint8_t i = 0; i < LEDS; ++i)
+  {
+    initMember(i);
+    group.add(members[i]);
+    group.setRGB(i, 255, 0, 0);
+  }
+
+  const uint32_t t0 = 5000;
+  mockSetMillis(t0);
+  for (uint8_t i = 0; i < LEDS; ++i) group.blink(i, half[i], cycles[i]);
+
+  uint32_t now = t0, polls = 0, mismatches = 0, bursts = 0;
+  while (now - t0 < 60000)
+  {
+    const uint32_t r = nextRandom();
+    now += (r % 8 == 0) ? (uint32_t)(r % 700) : (uint32_t)(r % 5);
+    for (uint8_t i = 0; i < LEDS; ++i) redWrites[i] = 0;
+    group.update(now);
+    ++polls;
+
+    for (uint8_t i = 0; i < LEDS; ++i)
+    {
+      const uint32_t k = (now - t0) / half[i];
+      const bool done = cycles[i] && k >= 2UL * cycles[i];
+      const bool want = !done && (k & 1) == 0;
+      if (lit(i) != want) ++mismatches;
+      if (redWrites[i] > 1) ++bursts;
+      if (cycles[i]) HT_CHECK_EQ(group.isBlinking((uint8_t)i), !done);
+    }
+  }
+  printf("stall catch-up: %u polls, %u mismatches, %u multi-write polls\n", polls, mismatches, bursts);
+  HT_CHECK_EQ(mismatches, 0);
+  HT_CHECK_EQ(bursts, 0);
+}
+
+/// A stall longer than the remaining cycles ends a finite blink dark, in one poll.
+static void finiteEndsInStall(void)
+{
+  RGBLEDGroup<1> group;
+  initMember(0);
+  group.add(members[0]);
+  group.setRGB(0, 255, 0, 0);
+  mockSetMillis(0);
+  group.blink(0, 50, 3);
+  group.update(60);                  // OFF, one cycle closed
+  HT_CHECK(!lit(0));
+  group.update(120);                 // ON
+  HT_CHECK(lit(0));
+  group.update(10000);
+  HT_CHECK(!lit(0));
+  HT_CHECK(!group.isBlinking(0));
+  HT_CHECK_EQ(group.activeCount(), 0);
+}
+
+/// setBrightness before add(): the new member is dimmed too, without a power budget.
+static void brightnessOnAdd(void)
+{
+  RGBLEDGroup<2> group;
+  initMember(0);
+  initMember(1);
+  group.add(members[0]);
+  group.setBrightness(100);
+  group.add(members[1]);
+  group.setRGB(0, 255, 255, 255);
+  group.setRGB(1, 255, 255, 255);
+  HT_CHECK_EQ(mockPinDuty(pinOf(0)), mockPinDuty(pinOf(1)));
+  HT_CHECK(mockPinDuty(pinOf(1)) < 255);
+}
+
+int main()
+{
+  mockReset();
+  mockSetWriteHook(countWrites);
+
+  stallCatchUp();
+  finiteEndsInStall();
+  brightnessOnAdd();
+
+  return HT_RESULT();
+}
@@ -0,0 +1,70 @@
+/**
+ * @file test_pattern.cpp
+ * @brief Pattern validator cases, and a REPEAT after a JUMP out of another repeat body running
+ *        its full count. Built with RGBLED_ENABLE_PATTERNS=1.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Pattern.h"
+#include "host_test.h"
+
+// Enters the red body mid-way; after the first REPEAT the body's JUMP leaves the open loop.
+static constexpr uint8_t JUMP_OUT[] PROGMEM = {
+  RGBLED_P_JUMP(5),                                  //  0
+  RGBLED_P_JUMP(15),                                 //  2: red body [2, 12) starts here
+  RGBLED_P_OFF(),                                    //  4
+  RGBLED_P_COLOR(255, 0, 0), RGBLED_P_HOLD(10),      //  5, 9
+  RGBLED_P_REPEAT(3, 2),                             // 12
+  RGBLED_P_COLOR(0, 255, 0), RGBLED_P_HOLD(10),      // 15, 19
+  RGBLED_P_OFF(),            RGBLED_P_HOLD(10),      // 22, 23
+  RGBLED_P_REPEAT(4, 15),                            // 26: green must blink 4 times
+  RGBLED_P_END()                                     // 29
+};
+static_assert(RGBLED_patternValid(JUMP_OUT, sizeof(JUMP_OUT)), "jump out of a repeat body is valid");
+
+static constexpr uint8_t NESTED[] = {
+  RGBLED_P_OFF(), RGBLED_P_REPEAT(2, 0), RGBLED_P_REPEAT(2, 0), RGBLED_P_END()
+};
+static_assert(!RGBLED_patternValid(NESTED, sizeof(NESTED)), "nested repeat must be rejected");
+
+static constexpr uint8_t MID_OP_JUMP[] = { RGBLED_P_HOLD(10), RGBLED_P_JUMP(1) };
+static_assert(!RGBLED_patternValid(MID_OP_JUMP, sizeof(MID_OP_JUMP)), "jump into an operand must be rejected");
+
+static constexpr uint8_t FALLS_OFF[] = { RGBLED_P_COLOR(1, 2, 3), RGBLED_P_HOLD(10) };
+static_assert(!RGBLED_patternValid(FALLS_OFF, sizeof(FALLS_OFF)), "no END/JUMP at the end must be rejected");
+
+static constexpr uint8_t ZERO_COUNT[] = { RGBLED_P_OFF(), RGBLED_P_REPEAT(0, 0), RGBLED_P_END() };
+static_assert(!RGBLED_patternValid(ZERO_COUNT, sizeof(ZERO_COUNT)), "repeat count 0 must be rejected");
+
+static const uint8_t PIN_G = 10;
+static uint32_t greenOn = 0;
+static int greenLast = 0;
+
+/// Counts OFF -> ON transitions of the green pin.
+static void countGreen(uint8_t pin, int value, bool)
+{
+  if (pin != PIN_G) return;
+  if (value && !greenLast) ++greenOn;
+  greenLast = value;
+}
+
+int main()
+{
+  mockReset();
+  mockSetWriteHook(countGreen);
+
+  RGBLED led;
+  led.parameters.RED_PIN     = 9;
+  led.parameters.GREEN_PIN   = PIN_G;
+  led.parameters.BLUE_PIN    = 11;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  led.init();
+
+  led.playPattern(JUMP_OUT);
+  for (uint32_t t = 0; t < 1000 && led.isPlaying(); ++t) { mockAdvanceMillis(1); led.update(); }
+  HT_CHECK(!led.isPlaying());
+  printf("green blinks after jump-out: %u (expected 4)\n", greenOn);
+  HT_CHECK_EQ(greenOn, 4);
+
+  return HT_RESULT();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_power_budget.cpp
+ * @brief RGBLEDGroup power budget: the estimate stays within the budget for all-white, partial
+ *        and random colour sets, the applied brightness is the largest that fits (capped by
+ *        setBrightness), members get it through setBrightness, and it rises again as colours
+ *        get darker.
+ */
+
+#include "RGBLED.h"
+#include "RGBLEDGroup.h"
+#include "host_test.h"
+
+static const uint8_t LEDS = 24;                 // 72 mock pins, 2..73
+static uint8_t pinOf(uint8_t led, uint8_t c) { return (uint8_t)(2 + 3 * led + c); }
+
+static RGBLED members[LEDS];
+static RGBLEDGroup<LEDS> group;
+static uint8_t colour[LEDS][3];
+static const uint16_t MA[3] = { 18, 22, 15 };
+
+static uint32_t rng = 4242;
+static uint32_t nextRandom(void) { rng = rng * 1664525UL + 1013904223UL; return rng >> 8; }
+
+/// Full-brightness current recomputed from scratch, in mA (rounded up), for comparison with
+/// the group's running total.
+static uint32_t fullCurrent(void)
+{
+  uint32_t load = 0;
+  for (uint8_t i = 0; i < LEDS; ++i)
+    for (uint8_t c = 0; c < 3; ++c) load += (uint32_t)colour[i][c] * MA[c];
+  return (load + 254) / 255;
+}
+
+static void setColour(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+{
+  colour[i][0] = r; colour[i][1] = g; colour[i][2] = b;
+  group.setRGB(i, r, g, b);
+}
+
+/// Checks the invariants of the limiter for the current colours, budget and requested brightness.
+static uint32_t check(uint32_t budget, uint8_t requested)
+{
+  uint32_t bad = 0;
+  const uint32_t full = fullCurrent();
+  const uint8_t applied = group.appliedBrightness();
+
+  // Largest brightness whose estimate fits, capped by the requested value.
+  uint32_t best = requested;
+  if (budget && full > budget) best = budget * 255UL / full;
+  if (best > requested) best = requested;
+
+  if (applied != best) ++bad;
+  if (budget && group.estimatedCurrent() > budget && applied > 0) ++bad;
+  if (group.isPowerLimited() != (applied < requested)) ++bad;
+
+  // Every member runs at the applied brightness: a full channel shows its duty.
+  for (uint8_t i = 0; i < LEDS; ++i)
+  {
+    if (colour[i][0] != 255) continue;
+    if (mockPinDuty(pinOf(i, 0)) != applied) ++bad;
+  }
+  return bad;
+}
+
+int main()
+{
+  mockReset();
+  for (uint8_t i = 0; i < LEDS; ++i)
+  {
+    members[i].parameters.RED_PIN     = pinOf(i, 0);
+    members[i].parameters.GREEN_PIN   = pinOf(i, 1);
+    members[i].parameters.BLUE_PIN    = pinOf(i, 2);
+    members[i].parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+    members[i].init();
+    members[i].enablePWM(true);
+    group.add(members[i]);
+  }
+  group.setCurrentModel(MA[0], MA[1], MA[2]);
+
+  // All white: 24 x 55 mA = 1320 mA against 600 mA.
+  const uint32_t budget = 600;
+  group.setPowerBudget(budget);
+  for (uint8_t i = 0; i < LEDS; ++i) setColour(i, 255, 255, 255);
+  HT_CHECK_EQ(group.estimatedCurrent() <= budget, true);
+  HT_CHECK_EQ(group.appliedBrightness(), budget * 255 / 1320);
+  HT_CHECK(group.isPowerLimited());
+  HT_CHECK_EQ(check(budget, 255), 0);
+
+  // Half of them dark: more headroom.
+  const uint8_t limitedWhite = group.appliedBrightness();
+  for (uint8_t i = 0; i < LEDS; i += 2) setColour(i, 0, 0, 0);
+  HT_CHECK(group.appliedBrightness() > limitedWhite);
+  HT_CHECK_EQ(check(budget, 255), 0);
+
+  // Random colours, budgets and requested brightness.
+  uint32_t bad = 0;
+  uint8_t requested = 255;
+  uint32_t b = budget;
+  for (uint32_t n = 0; n < 20000; ++n)
+  {
+    const uint32_t r = nextRandom();
+    if (r % 97 == 0)      { b = (r >> 8) % 1500; group.setPowerBudget(b); }
+    else if (r % 89 == 0) { requested = (uint8_t)(r >> 8); group.setBrightness(requested); }
+    else
+    {
+      const uint8_t i = (uint8_t)((r >> 4) % LEDS);
+      const uint32_t v = nextRandom();
+      setColour(i, (r & 1) ? 255 : (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16));
+    }
+    bad += check(b, requested);
+  }
+  printf("power budget: 20000 random steps, %u violations\n", bad);
+  HT_CHECK_EQ(bad, 0);
+
+  // No budget: the requested brightness applies unchanged.
+  group.setPowerBudget(0);
+  group.setBrightness(200);
+  HT_CHECK(!group.isPowerLimited());
+  HT_CHECK_EQ(group.appliedBrightness(), 200);
+  HT_CHECK_EQ(check(0, 200), 0);
+
+  return HT_RESULT();
+}
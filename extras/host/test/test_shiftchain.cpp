@@ -0,0 +1,148 @@
+/**
+ * @file test_shiftchain.cpp
+ * @brief Shift-register chain on the mock SPI: bit layout on the wire, BAM planes, the
+ *        RGBLED_ChainSlotDriver path of RGBLED and RGBLED_Fixed, and bytes/frame plus the
+ *        refresh limit for 64, 256 and 1024 LEDs (the README table).
+ *        Built with RGBLED_PWM_DRIVER=RGBLED_ChainSlotDriver.
+ */
+
+#include <SPI.h>
+#include "RGBLED.h"
+#include "RGBLED_Fixed.h"
+#include "RGBLED_ShiftChain.h"
+#include "host_test.h"
+
+static const uint8_t LATCH_PIN = 10;
+
+/// Farthest register first, MSB first: channel 11 is bit 3 of the first byte on the wire.
+static void wireLayout(void)
+{
+  RGBLED_ShiftChain<4, RGBLED_ShiftSPI<LATCH_PIN>, 8> chain;   // 12 channels, 2 registers
+  chain.begin();
+  HT_CHECK_EQ(mockPinMode(LATCH_PIN), OUTPUT);
+
+  chain.setRGB(0, 255, 0, 0);
+  chain.setRGB(3, 0, 0, 1);
+  mockSpiReset();
+  HT_CHECK(chain.flush());
+  HT_CHECK(!chain.flush());                       // clean frame: nothing on the wire
+  HT_CHECK_EQ(mockSpi.transactions, 1);
+  HT_CHECK_EQ(mockSpi.logLen, 2);
+  HT_CHECK_EQ(mockSpi.log[0], 0x08);
+  HT_CHECK_EQ(mockSpi.log[1], 0x01);
+  HT_CHECK_EQ(mockPinLevel(LATCH_PIN), LOW);
+
+  // BAM: plane b carries bit b of every level; weights 1, 2, 4, ... 128.
+  for (uint8_t b = 0; b < 8; ++b)
+  {
+    HT_CHECK_EQ(chain.tick(), 1u << b);
+    HT_CHECK_EQ(mockSpi.log[0], b == 0 ? 0x08 : 0x00);
+    HT_CHECK_EQ(mockSpi.log[1], 0x01);
+  }
+  HT_CHECK_EQ(chain.frames(), 3);                 // begin(), flush(), one BAM cycle
+  HT_CHECK_EQ(mockSpi.outsideTransaction, 0);
+
+  // Active-low registers: every bit on the wire is inverted.
+  RGBLED_ShiftChain<4, RGBLED_ShiftSPI<LATCH_PIN>, 1, RGBLED_ACTIVE_LOW> sink;
+  sink.begin();
+  sink.setRGB(0, 1, 0, 0);
+  sink.flush();
+  HT_CHECK_EQ(mockSpi.log[0], 0xFF);
+  HT_CHECK_EQ(mockSpi.log[1], 0xFE);
+}
+
+/// RGBLED and RGBLED_Fixed write their duties into chain slots instead of MCU pins.
+static void slotDriver(void)
+{
+  static RGBLED_ShiftChain<8, RGBLED_ShiftSPI<LATCH_PIN>, 8> chain;
+  chain.begin();
+
+  RGBLED a, b;
+  a.parameters.RED_PIN = 2; a.parameters.GREEN_PIN = 3; a.parameters.BLUE_PIN = 4;
+  b.parameters.RED_PIN = 5; b.parameters.GREEN_PIN = 6; b.parameters.BLUE_PIN = 7;
+  a.parameters.ACTIVE_MODE = b.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  HT_CHECK(a.init());
+  HT_CHECK(b.init());
+  a.enablePWM(true);
+  b.enablePWM(true);
+  a.setRGB(10, 20, 30);                         // before attach: replayed by attach()
+  a.driver().attach(chain, 2);
+  b.driver().attach(chain, 7);
+  b.setRGB(255, 0, 128);
+
+  HT_CHECK_EQ(chain.channel(6), 10);
+  HT_CHECK_EQ(chain.channel(7), 20);
+  HT_CHECK_EQ(chain.channel(8), 30);
+  HT_CHECK_EQ(chain.channel(21), 255);
+  HT_CHECK_EQ(chain.channel(23), 128);
+  HT_CHECK_EQ(mockPinDuty(2), -1);              // the MCU pins never see PWM
+  HT_CHECK_EQ(mockPinDuty(5), -1);
+
+  a.setBrightness(128);
+  HT_CHECK_EQ(chain.channel(7), RGBLED_scale8(20, 128));
+  a.off();
+  HT_CHECK_EQ(chain.channel(6) | chain.channel(7) | chain.channel(8), 0);
+  HT_CHECK_EQ(chain.channel(21), 255);          // other slot untouched
+  b.enablePWM(false);                           // release: slot OFF, not frozen
+  HT_CHECK_EQ(chain.channel(21) | chain.channel(23), 0);
+
+  RGBLED_Fixed<8, 9, 11, RGBLED_ACTIVE_HIGH, RGBLED_ChainSlotDriver> f;
+  f.init();
+  f.driver().attach(chain, 4);
+  f.enablePWM(true);
+  f.setRGB(1, 2, 3);
+  HT_CHECK_EQ(f.driver().slot(), 4);
+  HT_CHECK_EQ(chain.channel(12), 1);
+  HT_CHECK_EQ(chain.channel(13), 2);
+  HT_CHECK_EQ(chain.channel(14), 3);
+  HT_CHECK_EQ(mockPinDuty(9), -1);
+  HT_CHECK(chain.dirty());
+}
+
+/// One BAM frame at 8 MHz SPI on a 16 MHz AVR: bytes on the wire and the refresh limit.
+/// The shortest slot (1 tick) must hold one plane, so a frame lasts at least
+/// (2^BITS - 1) planes. Plane time = SPI bytes + transaction + latch pulse.
+template <uint16_t LEDS, uint8_t BITS>
+static void frameRate(void)
+{
+  typedef RGBLED_ShiftChain<LEDS, RGBLED_ShiftSPI<LATCH_PIN, 8000000UL>, BITS> Chain;
+  static Chain chain;
+  chain.begin();
+  for (uint16_t i = 0; i < LEDS; ++i) chain.setRGB(i, (uint8_t)(i * 7), (uint8_t)(i * 13), (uint8_t)(i * 29));
+
+  chain.resetStats();
+  mockSpiReset();
+  mockResetCounters();
+  for (uint8_t b = 0; b < BITS; ++b) chain.tick();
+
+  const uint32_t bytesPerFrame = chain.bytesSent() / chain.frames();
+  const double planeUs = (double)mockCalls.cycles / BITS * 1e6 / F_CPU;
+  const double refreshHz = 1e6 / (planeUs * ((1u << BITS) - 1));
+
+  HT_CHECK_EQ(chain.frames(), 1);
+  HT_CHECK_EQ(bytesPerFrame, (uint32_t)BITS * Chain::BYTES);
+  HT_CHECK_EQ(mockSpi.bytes, bytesPerFrame);
+  HT_CHECK_EQ(mockSpi.transactions, BITS);
+  HT_CHECK_EQ(mockSpi.clock, 8000000UL);
+  HT_CHECK_EQ(mockSpi.outsideTransaction, 0);
+  printf("| %4u | %d | %3u | %4u | %7.1f us | %7.1f Hz |\n", LEDS, BITS, Chain::BYTES,
+         (unsigned)bytesPerFrame, planeUs, refreshHz);
+}
+
+int main()
+{
+  mockReset();
+
+  wireLayout();
+  slotDriver();
+
+  printf("| LEDs | bits | bytes/plane | bytes/frame | plane time | max refresh |\n");
+  frameRate<64, 8>();
+  frameRate<64, 4>();
+  frameRate<256, 8>();
+  frameRate<256, 4>();
+  frameRate<1024, 8>();
+  frameRate<1024, 4>();
+
+  return HT_RESULT();
+}
@@ -0,0 +1,38 @@
+/**
+ * @file test_sizeof.cpp
+ * @brief Per-instance RAM of RGBLED, RGBLED_Fixed and the blink timer on a 64-bit host.
+ * @details Built twice: with default flags (test_sizeof) and with every per-LED feature
+ *          compiled in (test_sizeof_all). The AVR default budget (44 bytes) is enforced by
+ *          a static_assert in RGBLED.cpp; these limits catch growth on the host build.
+ */
+
+#include "RGBLED.h"
+#include "RGBLED_Fixed.h"
+#include "host_test.h"
+
+#define RGBLED_ALL_FEATURES (RGBLED_ENABLE_FADE && RGBLED_ENABLE_PATTERNS && RGBLED_ENABLE_EFFECTS && \
+                             RGBLED_ENABLE_COLOR_TABLE && RGBLED_ENABLE_SOFTPWM)
+
+int main()
+{
+  const size_t led   = sizeof(RGBLED);
+  const size_t fixed = sizeof(RGBLED_Fixed<9, 10, 11>);
+  const size_t timer = sizeof(RGBLED_BlinkTimer);
+
+  printf("sizeof(RGBLED)=%u  sizeof(RGBLED_Fixed)=%u  sizeof(RGBLED_BlinkTimer)=%u  (%s)\n",
+         (unsigned)led, (unsigned)fixed, (unsigned)timer,
+         RGBLED_ALL_FEATURES ? "all features" : "default flags");
+
+  if (sizeof(void*) == 8 && !RGBLED_ENABLE_STATS && !RGBLED_ENABLE_DITHER && !RGBLED_ENABLE_TRACE)
+  {
+    HT_CHECK(timer <= 16);              // 13 bytes + padding
+    HT_CHECK(fixed <= 48);
+#if RGBLED_ALL_FEATURES
+    HT_CHECK(led <= 120);
+#else
+    HT_CHECK(led <= 56);                // 44 bytes on AVR (no port cache on the host)
+#endif
+  }
+
+  return HT_RESULT();
+}
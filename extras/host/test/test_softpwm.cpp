@@ -0,0 +1,116 @@
+/**
+ * @file test_softpwm.cpp
+ * @brief RGBLED_SoftPWM on fake port registers: exact duty per frame, untouched foreign bits,
+ *        8 interrupts per frame, ISR cost stats, all-or-nothing capacity check. Built with
+ *        RGBLED_SOFTPWM_ISR_TIMING=1.
+ */
+
+#include "RGBLED_SoftPWM.h"
+#include "host_test.h"
+
+#include <chrono>
+
+static volatile uint8_t portA = 0;
+static volatile uint8_t portB = 0;
+
+struct Channel { volatile uint8_t* reg; uint8_t mask; uint8_t duty; };
+
+int main()
+{
+  mockReset();
+
+  RGBLED_SoftPWM pwm;
+  Channel ch[] = {
+    { &portA, 0x01, 0 },   { &portA, 0x02, 1 },   { &portA, 0x08, 127 },
+    { &portA, 0x10, 128 }, { &portB, 0x01, 255 }, { &portB, 0x04, 77 },
+    { &portB, 0x40, 200 },
+  };
+  const uint8_t n = sizeof(ch) / sizeof(ch[0]);
+
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    HT_CHECK_EQ(pwm.addChannel(ch[i].reg, ch[i].mask), i);
+    pwm.setDuty(i, ch[i].duty);
+  }
+  HT_CHECK_EQ(pwm.portCount(), 2);
+
+  // Bits that belong to no channel must survive every ISR write.
+  portA = 0x80;
+  portB = 0x80;
+
+  // Integrate the ON time of every pin over whole frames: each isr() call latches one bit
+  // plane and returns how many ticks it stays on the pins.
+  const uint32_t FRAMES = 50;
+  uint32_t onTicks[n] = {0};
+  uint32_t ticks = 0;
+  for (uint32_t c = 0; c < FRAMES * 8; ++c)
+  {
+    const uint8_t t = pwm.isr();
+    ticks += t;
+    for (uint8_t i = 0; i < n; ++i)
+      if (*ch[i].reg & ch[i].mask) onTicks[i] += t;
+    HT_CHECK((portA & 0x80) && (portB & 0x80));
+  }
+  HT_CHECK_EQ(ticks, FRAMES * 255);
+  for (uint8_t i = 0; i < n; ++i) HT_CHECK_EQ(onTicks[i], FRAMES * ch[i].duty);
+
+  // 8 interrupts per frame, independent of the channel count.
+  RGBLED_SoftPWM::Stats s = pwm.stats();
+  HT_CHECK_EQ(s.isrCalls, FRAMES * 8);
+  HT_CHECK_EQ(s.frames, FRAMES);
+
+  // A disabled channel is left alone for other code to drive.
+  pwm.enableChannel(4, false);
+  portB = (uint8_t)(portB & ~0x01);
+  for (uint8_t c = 0; c < 8; ++c) pwm.isr();
+  HT_CHECK_EQ(portB & 0x01, 0);
+
+  // Cost stats: the mock micros() advances 3 us per read, so every call measures 3.
+  pwm.resetStats();
+  mockSetMicrosStep(3);
+  for (uint8_t c = 0; c < 16; ++c) pwm.isr();
+  mockSetMicrosStep(0);
+  s = pwm.stats();
+  HT_CHECK_EQ(s.isrCostMin, 3);
+  HT_CHECK_EQ(s.isrCostMax, 3);
+  pwm.resetStats();
+  s = pwm.stats();
+  HT_CHECK_EQ(s.isrCostMin, 0);
+  HT_CHECK_EQ(s.isrCostMax, 0);
+
+  // Capacity check for a group of pins (an LED's three channels) before adding any of them.
+  {
+    static volatile uint8_t regs[RGBLED_SOFTPWM_MAX_PORTS + 1];
+    RGBLED_SoftPWM e;
+    for (uint8_t p = 0; p + 1 < RGBLED_SOFTPWM_MAX_PORTS; ++p) e.addChannel(&regs[p], 0x01);
+    volatile uint8_t* const oneNew[3] = { &regs[0], &regs[RGBLED_SOFTPWM_MAX_PORTS - 1], &regs[RGBLED_SOFTPWM_MAX_PORTS - 1] };
+    volatile uint8_t* const twoNew[3] = { &regs[0], &regs[RGBLED_SOFTPWM_MAX_PORTS - 1], &regs[RGBLED_SOFTPWM_MAX_PORTS] };
+    volatile uint8_t* const withNull[3] = { &regs[0], nullptr, &regs[1] };
+    HT_CHECK(e.canAdd(oneNew, 3));
+    HT_CHECK(!e.canAdd(twoNew, 3));
+    HT_CHECK(!e.canAdd(withNull, 3));
+    HT_CHECK_EQ(e.channelCount(), RGBLED_SOFTPWM_MAX_PORTS - 1);   // checks add nothing
+
+    while (e.channelCount() + 2 < RGBLED_SOFTPWM_MAX_CHANNELS) e.addChannel(&regs[0], 0x02);
+    HT_CHECK(!e.canAdd(oneNew, 3));                                // channel limit
+    HT_CHECK(e.canAdd(oneNew, 2));
+  }
+
+  // Host timing for reference: cost grows with ports, not channels.
+  for (uint8_t ports = 1; ports <= RGBLED_SOFTPWM_MAX_PORTS; ++ports)
+  {
+    static volatile uint8_t regs[RGBLED_SOFTPWM_MAX_PORTS];
+    RGBLED_SoftPWM e;
+    for (uint8_t p = 0; p < ports; ++p)
+      for (uint8_t b = 0; b < 6; ++b) e.setDuty((uint8_t)e.addChannel(&regs[p], (uint8_t)(1u << b)), (uint8_t)(b * 40));
+
+    const uint32_t CALLS = 400000;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t c = 0; c < CALLS; ++c) e.isr();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / CALLS;
+    printf("ports=%u channels=%u  host ns/isr=%.2f  stores/frame=%u\n",
+           ports, e.channelCount(), ns, 8u * ports);
+  }
+
+  return HT_RESULT();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_stream.cpp
+ * @brief Binary colour stream into an RGBLEDGroup: a corrupted frame never reaches the LEDs,
+ *        and with a staged group neither the colour cache nor the power estimate; valid
+ *        frames are shown whole.
+ *        Reports decoder throughput on the host, core cycles per frame on the mock AVR core
+ *        and the frame rate a serial link allows.
+ */
+
+#include "RGBLED.h"
+#include "RGBLEDGroup.h"
+#include "RGBLED_Stream.h"
+#include "host_test.h"
+
+#include <chrono>
+
+static const uint8_t LEDS = 32;                 // 96 mock pins, 2..97
+static uint8_t pinOf(uint8_t led, uint8_t c) { return (uint8_t)(2 + 3 * led + c); }
+
+static RGBLED members[LEDS];
+static RGBLEDGroup<LEDS> panel;               // pixels straight into the colour cache
+static RGBLEDGroup<LEDS, true> stagedPanel;   // same members, staging copy
+
+static void initPanel(void)
+{
+  for (uint8_t i = 0; i < LEDS; ++i)
+  {
+    members[i].parameters.RED_PIN     = pinOf(i, 0);
+    members[i].parameters.GREEN_PIN   = pinOf(i, 1);
+    members[i].parameters.BLUE_PIN    = pinOf(i, 2);
+    members[i].parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+    members[i].init();
+    members[i].enablePWM(true);
+    panel.add(members[i]);
+    stagedPanel.add(members[i]);
+  }
+}
+
+static bool shows(uint8_t led, const uint8_t* rgb)
+{
+  return mockPinDuty(pinOf(led, 0)) == rgb[0] && mockPinDuty(pinOf(led, 1)) == rgb[1] &&
+         mockPinDuty(pinOf(led, 2)) == rgb[2];
+}
+
+/// Staged group: a frame with a bad CRC leaves no trace; the frame after it is shown.
+static void corruptFrameStaged(void)
+{
+  RGBLEDGroup<LEDS, true>& panel = stagedPanel;
+  RGBLED_StreamDecoder<RGBLEDGroup<LEDS, true> > decoder(panel);
+  uint8_t frame[RGBLED_STREAM_OVERHEAD + 3 * 4];
+  const uint8_t good[12] = { 10, 20, 30,  40, 50, 60,  70, 80, 90,  1, 2, 3 };
+  const uint8_t bad[12]  = { 255, 255, 255,  255, 255, 255,  255, 255, 255,  255, 255, 255 };
+
+  uint16_t n = RGBLED_streamEncode(frame, 4, 4, good);
+  HT_CHECK_EQ(decoder.feed(frame, n), 1);
+  const uint32_t current = panel.estimatedCurrent();
+  for (uint8_t k = 0; k < 4; ++k) HT_CHECK(shows((uint8_t)(4 + k), &good[3 * k]));
+
+  // LED 4 blinks: its ON edge shows the group's cached colour.
+  mockSetMillis(0);
+  panel.blink(4, 100, 0);
+
+  n = RGBLED_streamEncode(frame, 4, 4, bad);
+  frame[n - 1] ^= 0x01;                         // wrong CRC
+  HT_CHECK_EQ(decoder.feed(frame, n), 0);
+  HT_CHECK_EQ(decoder.crcErrors(), 1);
+  HT_CHECK_EQ(panel.estimatedCurrent(), current);
+  for (uint8_t k = 1; k < 4; ++k) HT_CHECK(shows((uint8_t)(4 + k), &good[3 * k]));
+
+  panel.update(100);                            // OFF
+  panel.update(200);                            // ON: cached colour, not the dropped one
+  HT_CHECK(shows(4, &good[0]));
+  panel.stopBlink(4, false);
+
+  // Range outside the panel: header error, nothing shown.
+  const uint32_t writes = mockPinWrites();
+  n = RGBLED_streamEncode(frame, LEDS - 2, 4, bad);
+  HT_CHECK_EQ(decoder.feed(frame, n), 0);
+  HT_CHECK_EQ(decoder.headerErrors(), 1);
+  HT_CHECK_EQ(mockPinWrites(), writes);
+
+  // The next valid frame for the same LEDs is shown whole.
+  n = RGBLED_streamEncode(frame, 4, 4, bad);
+  HT_CHECK_EQ(decoder.feed(frame, n), 1);
+  for (uint8_t k = 0; k < 4; ++k) HT_CHECK(shows((uint8_t)(4 + k), &bad[3 * k]));
+  HT_CHECK(panel.estimatedCurrent() > current);
+}
+
+/// Default group: a frame with a bad CRC writes no pin; the frame after it is shown.
+static void corruptFrame(void)
+{
+  RGBLED_StreamDecoder<RGBLEDGroup<LEDS> > decoder(panel);
+  uint8_t frame[RGBLED_STREAM_OVERHEAD + 3 * 4];
+  const uint8_t good[12] = { 11, 21, 31,  41, 51, 61,  71, 81, 91,  2, 3, 4 };
+  const uint8_t bad[12]  = { 200, 200, 200,  200, 200, 200,  200, 200, 200,  200, 200, 200 };
+
+  uint16_t n = RGBLED_streamEncode(frame, 8, 4, good);
+  HT_CHECK_EQ(decoder.feed(frame, n), 1);
+  for (uint8_t k = 0; k < 4; ++k) HT_CHECK(shows((uint8_t)(8 + k), &good[3 * k]));
+
+  const uint32_t writes = mockPinWrites();
+  n = RGBLED_streamEncode(frame, 8, 4, bad);
+  frame[n - 2] ^= 0x80;                         // wrong CRC
+  HT_CHECK_EQ(decoder.feed(frame, n), 0);
+  HT_CHECK_EQ(decoder.crcErrors(), 1);
+  HT_CHECK_EQ(mockPinWrites(), writes);
+  for (uint8_t k = 0; k < 4; ++k) HT_CHECK(shows((uint8_t)(8 + k), &good[3 * k]));
+
+  n = RGBLED_streamEncode(frame, 8, 4, good);
+  HT_CHECK_EQ(decoder.feed(frame, n), 1);
+  for (uint8_t k = 0; k < 4; ++k) HT_CHECK(shows((uint8_t)(8 + k), &good[3 * k]));
+
+  // Only the staged group pays for the staging copy.
+  printf("sizeof group: %u bytes, staged: %u bytes\n", (unsigned)sizeof(RGBLEDGroup<LEDS>),
+         (unsigned)sizeof(RGBLEDGroup<LEDS, true>));
+  HT_CHECK(sizeof(RGBLEDGroup<LEDS, true>) >= sizeof(RGBLEDGroup<LEDS>) + 3 * LEDS);
+}
+
+/// Sink that discards the colours: isolates the decoder cost.
+struct NullSink
+{
+  uint32_t staged = 0, shown = 0;
+  uint8_t size(void) const { return LEDS; }
+  void stageRGB(uint8_t, uint8_t r, uint8_t g, uint8_t b) { staged += (uint32_t)r + g + b; }
+  void showRange(uint8_t, uint8_t count) { shown += count; }
+};
+
+template <class SINK>
+static double decodeRate(SINK& sink, const uint8_t* stream, uint32_t len, uint32_t frames, uint32_t repeat)
+{
+  RGBLED_StreamDecoder<SINK> decoder(sink);
+  const auto t0 = std::chrono::steady_clock::now();
+  uint32_t got = 0;
+  for (uint32_t r = 0; r < repeat; ++r) got += decoder.feed(stream, (uint16_t)len);
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  HT_CHECK_EQ(got, frames * repeat);
+  HT_CHECK_EQ(decoder.crcErrors() + decoder.headerErrors(), 0);
+  return (double)len * repeat / s;
+}
+
+/// Full-panel frames: host bytes/s, mock AVR core cycles per frame, serial-link frame rates.
+static void throughput(void)
+{
+  static const uint16_t FRAMES = 600;
+  const uint16_t frameSize = RGBLED_streamFrameSize(LEDS);
+  static uint8_t stream[FRAMES * (RGBLED_STREAM_OVERHEAD + 3 * LEDS)];
+  uint8_t rgb[3 * LEDS];
+  uint32_t len = 0, frames = 0;
+  while (frames < FRAMES)
+  {
+    for (uint16_t i = 0; i < sizeof(rgb); ++i) rgb[i] = (uint8_t)(frames * 31 + i * 7);
+    len += RGBLED_streamEncode(stream + len, 0, LEDS, rgb);
+    ++frames;
+  }
+
+  NullSink nullSink;
+  const double decodeBps = decodeRate(nullSink, stream, len, frames, 200);
+
+  mockResetCounters();
+  const double panelBps = decodeRate(panel, stream, len, frames, 20);
+  const double cyclesPerFrame = (double)mockCalls.cycles / (frames * 20);
+
+  printf("stream: %u-LED frames of %u bytes\n", LEDS, frameSize);
+  printf("  decode only:    %.1f MB/s on the host\n", decodeBps / 1e6);
+  printf("  into the group: %.1f MB/s on the host, %.0f core cycles/frame on the mock AVR\n",
+         panelBps / 1e6, cyclesPerFrame);
+  const uint32_t bauds[3] = { 115200UL, 500000UL, 1000000UL };
+  for (uint8_t i = 0; i < 3; ++i)
+    printf("  %7u baud: %.0f frames/s (8N1)\n", (unsigned)bauds[i], bauds[i] / 10.0 / frameSize);
+}
+
+int main()
+{
+  mockReset();
+  initPanel();
+
+  corruptFrameStaged();
+  corruptFrame();
+  throughput();
+
+  return HT_RESULT();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_timebase.cpp
+ * @brief Shared timebase: every member follows the ideal phase-locked schedule with a future
+ *        origin, with stalls of more than one period, after more than 2^32 ms of running, and
+ *        on a schedule change after more than 2^31 ms of stall-free polling.
+ */
+
+#include "RGBLED_Timebase.h"
+#include "host_test.h"
+
+static const uint8_t  MEMBERS = 4;
+static const uint16_t PERIOD  = 800;  // 2^32 % 800 != 0, so unsigned wrap shows as a phase jump
+static const uint16_t OFFSET[MEMBERS] = { 0, 200, 450, 700 };
+static const uint16_t ON[MEMBERS]     = { 200, 200, 300, 250 };
+
+static RGBLED leds[MEMBERS];
+
+/// Red channel of member @p i lit, on the PWM or the digital path.
+static bool lit(uint8_t i)
+{
+  const uint8_t pin = (uint8_t)(2 + 3 * i);
+  const int duty = mockPinDuty(pin);
+  return duty >= 0 ? duty > 0 : mockPinLevel(pin) == HIGH;
+}
+
+/// Ideal state of member @p i at absolute time @p t (64-bit, never wraps).
+static bool expected(uint8_t i, uint64_t t, uint64_t origin)
+{
+  const int64_t d = (int64_t)(t - origin);
+  const int64_t phase = ((d % PERIOD) + PERIOD) % PERIOD;
+  const int64_t rel = ((phase - OFFSET[i]) % PERIOD + PERIOD) % PERIOD;
+  return rel < ON[i];
+}
+
+/// Sets the clock to @p t, runs the timebase and counts members off their schedule.
+static uint32_t step(RGBLED_Timebase<MEMBERS>& tb, uint64_t t, uint64_t origin)
+{
+  mockSetMillis((uint32_t)t);
+  tb.update();
+  uint32_t bad = 0;
+  for (uint8_t i = 0; i < MEMBERS; ++i) if (lit(i) != expected(i, t, origin)) ++bad;
+  return bad;
+}
+
+static void initLeds(RGBLED_Timebase<MEMBERS>& tb)
+{
+  for (uint8_t i = 0; i < MEMBERS; ++i)
+  {
+    leds[i].parameters.RED_PIN     = 2 + 3 * i;
+    leds[i].parameters.GREEN_PIN   = 3 + 3 * i;
+    leds[i].parameters.BLUE_PIN    = 4 + 3 * i;
+    leds[i].parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+    leds[i].init();
+    leds[i].red();
+    leds[i].off();
+    tb.join(leds[i], OFFSET[i], ON[i]);
+  }
+}
+
+/// Origin 3.2 periods ahead: the phase before it must already follow the schedule.
+static void futureOrigin(void)
+{
+  RGBLED_Timebase<MEMBERS> tb(PERIOD);
+  initLeds(tb);
+
+  const uint64_t t0 = 1000, origin = t0 + 3 * PERIOD + 130;
+  mockSetMillis((uint32_t)t0);
+  tb.start((uint32_t)origin);
+
+  uint32_t bad = 0;
+  for (uint64_t t = t0; t < t0 + 6 * PERIOD; ++t) bad += step(tb, t, origin);
+  printf("future origin: %u mismatches over %u ms\n", bad, 6 * PERIOD);
+  HT_CHECK_EQ(bad, 0);
+}
+
+/// Stalls of 1.5 and 2.4 periods between 1 ms polls.
+static void stalls(void)
+{
+  RGBLED_Timebase<MEMBERS> tb(PERIOD);
+  initLeds(tb);
+
+  const uint64_t origin = 5000;
+  mockSetMillis((uint32_t)origin);
+  tb.start();
+
+  uint32_t bad = 0;
+  uint64_t t = origin;
+  for (uint16_t round = 0; round < 20; ++round)
+  {
+    for (uint16_t k = 0; k < 300; ++k) bad += step(tb, ++t, origin);
+    t += (round & 1) ? (PERIOD * 12 / 5) : (PERIOD * 3 / 2) + round;
+    bad += step(tb, t, origin);
+  }
+  printf("stalls: %u mismatches\n", bad);
+  HT_CHECK_EQ(bad, 0);
+}
+
+/// Runs past 2^32 ms with polls 1.9 periods apart, then forces re-syncs by stalling and by
+/// changing the schedule; the start time is close to the wrap as well.
+static void longRun(void)
+{
+  RGBLED_Timebase<MEMBERS> tb(PERIOD);
+  initLeds(tb);
+
+  const uint64_t origin = 0xFFFFF000ULL;
+  mockSetMillis((uint32_t)origin);
+  tb.start();
+
+  uint32_t bad = 0;
+  uint64_t t = origin;
+  const uint64_t end = origin + 0x100000000ULL + 10 * PERIOD;
+  while (t < end) { t += PERIOD * 19 / 10; bad += step(tb, t, origin); }
+
+  t += 5 * PERIOD + 77;
+  bad += step(tb, t, origin);               // stall -> re-sync
+  tb.setPhase(0, OFFSET[0], ON[0]);          // schedule change -> re-sync
+  for (uint16_t k = 0; k < 2 * PERIOD; ++k) bad += step(tb, ++t, origin);
+  printf("long run: %u mismatches, origin now %lu\n", bad, (unsigned long)tb.origin());
+  HT_CHECK_EQ(bad, 0);
+
+  // The re-based origin is a phase 0 of the original schedule, less than 2^31 ms back.
+  const uint32_t back = (uint32_t)t - tb.origin();
+  HT_CHECK(back < 0x80000000UL);
+  HT_CHECK_EQ((t - back - origin) % PERIOD, 0);
+}
+
+/// Polls without a stall for more than 2^31 ms, then changes the schedule: the re-sync must
+/// not see a wrapped offset from a stale origin.
+static void setPhaseAfterLongPoll(void)
+{
+  RGBLED_Timebase<MEMBERS> tb(PERIOD);
+  initLeds(tb);
+
+  const uint64_t origin = 3000;
+  mockSetMillis((uint32_t)origin);
+  tb.start();
+
+  uint32_t bad = 0;
+  uint64_t t = origin;
+  const uint64_t end = origin + 0x80000000ULL + 3 * PERIOD;
+  while (t < end) { t += PERIOD * 9 / 10; bad += step(tb, t, origin); }  // never 2 periods late
+
+  tb.setPhase(1, OFFSET[1], ON[1]);         // re-sync without a stall
+  bad += step(tb, t, origin);
+  for (uint16_t k = 0; k < 2 * PERIOD; ++k) bad += step(tb, ++t, origin);
+  printf("setPhase after 2^31 ms: %u mismatches\n", bad);
+  HT_CHECK_EQ(bad, 0);
+  HT_CHECK((uint32_t)t - tb.origin() < 2U * PERIOD);
+}
+
+int main()
+{
+  mockReset();
+  futureOrigin();
+  stalls();
+  longRun();
+  setPhaseAfterLongPoll();
+  return HT_RESULT();
+}
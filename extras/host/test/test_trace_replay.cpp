@@ -0,0 +1,114 @@
+/**
+ * @file test_trace_replay.cpp
+ * @brief Output trace: finite, infinite and blocking blinks replay without timing error, and
+ *        writes skipped by redundant-write elision show up as redundant writes.
+ */
+
+#include "RGBLED.h"
+#include "host_test.h"
+
+static const uint8_t PIN_R = 9;
+
+static uint32_t redWrites = 0;
+
+/// Counts the writes that actually reached the red pin.
+static void countWrites(uint8_t pin, int, bool)
+{
+  if (pin == PIN_R) ++redWrites;
+}
+
+static void initLed(RGBLED& led)
+{
+  led.parameters.RED_PIN     = PIN_R;
+  led.parameters.GREEN_PIN   = 10;
+  led.parameters.BLUE_PIN    = 11;
+  led.parameters.ACTIVE_MODE = RGBLED_ACTIVE_HIGH;
+  led.init();
+  led.red();
+  led.off();
+}
+
+static void runFor(RGBLED& led, uint32_t ms)
+{
+  for (uint32_t i = 0; i < ms; ++i) { mockAdvanceMillis(1); led.update(); }
+}
+
+/// Replays the red pin and checks the schedule, and that the trace splits the requested writes
+/// exactly into real pin writes and elided ones. @p extraRedundant forced redundant writes
+/// (repeated off() calls) must all be among the elided ones.
+static void check(const char* name, RGBLED_Trace& trace, RGBLED_BlinkMode mode, uint16_t ms,
+                  uint32_t number, uint32_t t0, uint16_t edges, uint16_t extraRedundant)
+{
+  static RGBLED_TraceEvent ev[1024];
+  const uint16_t n = trace.read(ev, 1024);
+  HT_CHECK_EQ(trace.overwritten(), 0);
+
+  uint32_t real = 0, elided = 0;
+  for (uint16_t i = 0; i < n; ++i)
+  {
+    if (ev[i].pin != PIN_R) continue;
+    if (ev[i].elided) ++elided; else ++real;
+  }
+
+  const RGBLED_BlinkReport r = RGBLED_replayBlink(ev, n, PIN_R, LOW, mode, ms, number, t0);
+  printf("%-8s events=%u edges=%u/%u err=[%ld,%ld] missing=%u extra=%u redundant=%u\n", name,
+         n, r.matchedEdges, r.expectedEdges, (long)r.minError, (long)r.maxError,
+         r.missingEdges, r.extraEdges, r.redundantWrites);
+
+  HT_CHECK(r.ok(0));
+  HT_CHECK_EQ(r.expectedEdges, edges);
+  HT_CHECK_EQ(r.matchedEdges, edges);
+  HT_CHECK_EQ(real, redWrites);
+  HT_CHECK_EQ(r.redundantWrites, elided);
+  HT_CHECK(r.redundantWrites >= extraRedundant);
+}
+
+int main()
+{
+  mockReset();
+  mockSetMillis(1000);
+  mockSetWriteHook(countWrites);
+
+  RGBLED led;
+  initLed(led);
+  RGBLED_TraceBuffer<1024> trace;
+  led.attachTrace(&trace);
+
+  // Finite, non-blocking; the LED ends dark, so two more off() calls write nothing.
+  trace.clear(); redWrites = 0;
+  uint32_t t0 = millis();
+  led.blink(1203, 4, false);
+  runFor(led, 1400);
+  led.off();
+  led.off();
+  check("finite", trace, RGBLED_BLINK_FINITE, 1203, 4, t0, 8, 2);
+
+  // Blocking: delay() advances the mock clock.
+  trace.clear(); redWrites = 0;
+  t0 = millis();
+  led.blink(900, 3, true);
+  led.off();
+  check("blocking", trace, RGBLED_BLINK_BLOCKING, 900, 3, t0, 6, 1);
+
+  // Infinite: 2000 ms of 150 ms half-periods -> edges at 0, 150, ..., 1950.
+  trace.clear(); redWrites = 0;
+  t0 = millis();
+  led.blink(150, 0);
+  runFor(led, 2000);
+  check("infinite", trace, RGBLED_BLINK_INFINITE, 150, 0, t0, 14, 0);
+  led.stopBlink();
+
+  // Without elided writes the report must not invent any.
+  led.off();
+  trace.clear(); redWrites = 0;
+  led.red();
+  led.off();
+  static RGBLED_TraceEvent ev[8];
+  const uint16_t n = trace.read(ev, 8);
+  uint16_t redEvents = 0;
+  for (uint16_t i = 0; i < n; ++i) if (ev[i].pin == PIN_R) { ++redEvents; HT_CHECK(!ev[i].elided); }
+  HT_CHECK_EQ(redEvents, 2);
+  HT_CHECK_EQ(redWrites, 2);
+
+  return HT_RESULT();
+}